@@ -0,0 +1,51 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+// Asymmetric fences, which move the cost of a full fence from a frequent side of a
+// Dekker-style synchronization to a rare one:
+//
+//   Reader:                            Writer:
+//   hazard.store(p, relaxed);          src.store(q, relaxed);
+//   AsymmetricLightFence();            AsymmetricHeavyFence();
+//   src.load(relaxed);                 hazard.load(relaxed);
+//
+// Either the reader sees the store of the writer, or the writer sees that of the
+// reader, as with seq_cst fences on both sides.
+//
+// On Linux the heavy fence is membarrier(2), which runs a full fence on every CPU
+// running a thread of the process, and the light fence only prevents the compiler
+// from reordering. Elsewhere both are seq_cst fences.
+
+#pragma once
+
+#include <atomic>
+
+namespace wsd {
+
+namespace detail {
+
+// Set once membarrier(2) is registered for the process, before any heavy fence uses it.
+extern std::atomic<bool> g_heavy_fence_is_membarrier;
+
+}  // namespace detail
+
+inline void AsymmetricLightFence()
+{
+    if (detail::g_heavy_fence_is_membarrier.load(std::memory_order_relaxed)) {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    } else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+// Takes a system call, so it should be amortized over many light fences.
+void AsymmetricHeavyFence();
+
+// Sets up the heavy fence without running it, so that light fences are cheap from
+// the start, e.g. when constructing objects using them. Only the first call takes
+// system calls.
+void PrepareAsymmetricFences();
+
+}  // namespace wsd
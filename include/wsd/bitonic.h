@@ -6,14 +6,24 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
-namespace wsd {
+#include "wsd/counting_network.h"
+#include "wsd/detail/cache_line.h"
+#include "wsd/detail/layered_network.h"
 
-class Merger;
+namespace wsd {
 
-class Bitonic final {
+// The bitonic counting network of Aspnes, Herlihy and Shavit, of depth
+// log(width) * (log(width) + 1) / 2, compiled into a detail::LayeredNetwork.
+class Bitonic final : public CountingNetwork {
 public:
+    // `width' is a power of two. Each balancer takes a cache line of its own, so the
+    // network takes 64 * depth() * width / 2 bytes: 43 KB for a width of 64, 1.8 MB
+    // for 1024, but 3.2 GB for 2^19.
     explicit Bitonic(int width);
 
     ~Bitonic();
@@ -21,13 +31,47 @@ public:
     Bitonic(const Bitonic&) = delete;
     Bitonic& operator=(const Bitonic&) = delete;
 
-    int Traverse(int input);
+    int Traverse(int input) override;
+
+    int width() const override
+    {
+        return m_network.width();
+    }
+
+    int depth() const
+    {
+        return m_network.depth();
+    }
     
 private:
-    std::unique_ptr<Bitonic> m_half0;
-    std::unique_ptr<Bitonic> m_half1;
-    std::unique_ptr<Merger> m_merger;
-    const int m_width;
+    detail::LayeredNetwork m_network;
+};
+
+// A counter whose increments are spread over a bitonic network rather than all
+// hitting one atomic: a token leaving on wire i takes the next of the values i,
+// i + width, i + 2 * width, ... from a counter of its own wire. The values returned
+// are distinct, and in any quiescent state are exactly 0 to n - 1 for n increments.
+// Unlike fetch_add(), a call may return a smaller value than a call which completed
+// before it started.
+class BitonicCounter final {
+public:
+    // `width' is a power of two, e.g. the number of threads expected to contend. Takes
+    // the memory of a Bitonic of that width, plus a cache line per output wire.
+    explicit BitonicCounter(int width);
+
+    BitonicCounter(const BitonicCounter&) = delete;
+    BitonicCounter& operator=(const BitonicCounter&) = delete;
+
+    uint64_t GetAndIncrement();
+
+private:
+    struct Wire {
+        std::atomic<uint64_t> count{0};
+        char pad[detail::kCacheLineSize - sizeof(std::atomic<uint64_t>)];
+    };
+
+    Bitonic m_bitonic;
+    std::unique_ptr<Wire[]> m_wires;
 };
 
 }  // namespace wsd
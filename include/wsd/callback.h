@@ -2,6 +2,7 @@
 #define __CALLBACK_H__
 
 #include <memory>
+#include <utility>
 
 #include "callback_detail.h"
 
@@ -15,11 +16,12 @@
 // MEMORY MANAGEMENT AND PASSING
 //
 // The Callback objects themselves should be passed by const-reference, and stored by
-// copy. They internally store their state via a refcounted smart pointer and thus do not
-// need to be deleted.
+// copy. Small bound states (see CallbackStorage in callback_detail.h) are stored inside
+// the callback, so bind() does not allocate memory for them. Others are stored via a
+// refcounted pointer. Either way callbacks do not need to be deleted.
 //
-// The reason to pass via a const-reference is to avoid unnecessary increment/decrement to
-// the internal refcount.
+// The reason to pass via a const-reference is to avoid unnecessary copies of the
+// bound state, or increment/decrement to the internal refcount.
 //
 // ---------------------------------------------------------------------------
 // Quick Reference
@@ -164,461 +166,40 @@ class BindState;
 template <typename Signature>
 class Callback;
 
-template <typename R>
-class Callback<R(void)> {
+template <typename R, typename... Args>
+class Callback<R(Args...)> {
 private:
-    typedef R (*PolymorphicInvoke)(detail::BindStateBase*);
+    typedef R (*PolymorphicInvoke)(detail::BindStateBase*, typename detail::CallbackParamTraits<Args>::ForwardType...);
 
 public:
-    typedef R(RunType)(void);
+    typedef R(RunType)(Args...);
     typedef PolymorphicInvoke unspecified_bool_type;
 
-    Callback() : m_invoke(NULL)
+    Callback()
     {
     }
 
     // Should be private, but avoids template friendship issues.
     template <typename FunctorType, typename RunType, typename BoundArgsType>
-    Callback(detail::BindState<FunctorType, RunType, BoundArgsType>* bind_state)
-        : m_bind_state_ptr(bind_state),
-          m_invoke(&detail::BindState<FunctorType, RunType, BoundArgsType>::InvokerType::invoke)
+    Callback(detail::BindState<FunctorType, RunType, BoundArgsType>&& bind_state)
+        : m_storage(std::move(bind_state),
+                    reinterpret_cast<detail::CallbackStorage::InvokeFuncStorage>(
+                            &detail::BindState<FunctorType, RunType, BoundArgsType>::InvokerType::invoke))
     {
     }
 
-    R operator()() const
+    R operator()(typename detail::CallbackParamTraits<Args>::ForwardType... args) const
     {
-        return m_invoke(m_bind_state_ptr.get());
+        return m_storage.invoker<PolymorphicInvoke>()(m_storage.get(), args...);
     }
 
     operator unspecified_bool_type() const
     {
-        return m_invoke;
+        return m_storage.invoker<PolymorphicInvoke>();
     }
 
 private:
-    std::shared_ptr<detail::BindStateBase> m_bind_state_ptr;
-    PolymorphicInvoke m_invoke;
-};
-
-template <typename R, typename A1>
-class Callback<R(A1)> {
-private:
-    typedef R (*PolymorphicInvoke)(detail::BindStateBase*, typename detail::CallbackParamTraits<A1>::ForwardType);
-
-public:
-    typedef R(RunType)(A1);
-    typedef PolymorphicInvoke unspecified_bool_type;
-
-    Callback() : m_invoke(NULL)
-    {
-    }
-
-    // Should be private, but avoids template friendship issues.
-    template <typename FunctorType, typename RunType, typename BoundArgsType>
-    Callback(detail::BindState<FunctorType, RunType, BoundArgsType>* bind_state)
-        : m_bind_state_ptr(bind_state),
-          m_invoke(&detail::BindState<FunctorType, RunType, BoundArgsType>::InvokerType::invoke)
-    {
-    }
-
-    R operator()(typename detail::CallbackParamTraits<A1>::ForwardType a1) const
-    {
-        return m_invoke(m_bind_state_ptr.get(), a1);
-    }
-
-    operator unspecified_bool_type() const
-    {
-        return m_invoke;
-    }
-
-private:
-    std::shared_ptr<detail::BindStateBase> m_bind_state_ptr;
-    PolymorphicInvoke m_invoke;
-};
-
-template <typename R, typename A1, typename A2>
-class Callback<R(A1, A2)> {
-private:
-    typedef R (*PolymorphicInvoke)(detail::BindStateBase*,
-                                   typename detail::CallbackParamTraits<A1>::ForwardType,
-                                   typename detail::CallbackParamTraits<A2>::ForwardType);
-
-public:
-    typedef R(RunType)(A1, A2);
-    typedef PolymorphicInvoke unspecified_bool_type;
-
-    Callback() : m_invoke(NULL)
-    {
-    }
-
-    // Should be private, but avoids template friendship issues.
-    template <typename FunctorType, typename RunType, typename BoundArgsType>
-    Callback(detail::BindState<FunctorType, RunType, BoundArgsType>* bind_state)
-        : m_bind_state_ptr(bind_state),
-          m_invoke(&detail::BindState<FunctorType, RunType, BoundArgsType>::InvokerType::invoke)
-    {
-    }
-
-    R operator()(typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                 typename detail::CallbackParamTraits<A2>::ForwardType a2)
-    {
-        return m_invoke(m_bind_state_ptr.get(), a1, a2);
-    }
-
-    operator unspecified_bool_type() const
-    {
-        return m_invoke;
-    }
-
-private:
-    std::shared_ptr<detail::BindStateBase> m_bind_state_ptr;
-    PolymorphicInvoke m_invoke;
-};
-
-template <typename R, typename A1, typename A2, typename A3>
-class Callback<R(A1, A2, A3)> {
-private:
-    typedef R (*PolymorphicInvoke)(detail::BindStateBase*,
-                                   typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                                   typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                                   typename detail::CallbackParamTraits<A3>::ForwardType a3);
-
-public:
-    typedef R(RunType)(A1, A2, A3);
-    typedef PolymorphicInvoke unspecified_bool_type;
-
-    Callback() : m_invoke(NULL)
-    {
-    }
-
-    // Should be private, but avoids template friendship issues.
-    template <typename FunctorType, typename RunType, typename BoundArgsType>
-    Callback(detail::BindState<FunctorType, RunType, BoundArgsType>* bind_state)
-        : m_bind_state_ptr(bind_state),
-          m_invoke(&detail::BindState<FunctorType, RunType, BoundArgsType>::InvokerType::invoke)
-    {
-    }
-
-    R operator()(typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                 typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                 typename detail::CallbackParamTraits<A3>::ForwardType a3) const
-    {
-        return m_invoke(m_bind_state_ptr.get(), a1, a2, a3);
-    }
-
-    operator unspecified_bool_type() const
-    {
-        return m_invoke;
-    }
-
-private:
-    std::shared_ptr<detail::BindStateBase> m_bind_state_ptr;
-    PolymorphicInvoke m_invoke;
-};
-
-template <typename R, typename A1, typename A2, typename A3, typename A4>
-class Callback<R(A1, A2, A3, A4)> {
-private:
-    typedef R (*PolymorphicInvoke)(detail::BindStateBase*,
-                                   typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                                   typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                                   typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                                   typename detail::CallbackParamTraits<A4>::ForwardType a4);
-
-public:
-    typedef R(RunType)(A1, A2, A3, A4);
-    typedef PolymorphicInvoke unspecified_bool_type;
-
-    Callback() : m_invoke(NULL)
-    {
-    }
-
-    // Should be private, but avoids template friendship issues.
-    template <typename FunctorType, typename RunType, typename BoundArgsType>
-    Callback(detail::BindState<FunctorType, RunType, BoundArgsType>* bind_state)
-        : m_bind_state_ptr(bind_state),
-          m_invoke(&detail::BindState<FunctorType, RunType, BoundArgsType>::InvokerType::invoke)
-    {
-    }
-
-    R operator()(typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                 typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                 typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                 typename detail::CallbackParamTraits<A4>::ForwardType a4) const
-    {
-        return m_invoke(m_bind_state_ptr.get(), a1, a2, a3, a4);
-    }
-
-    operator unspecified_bool_type() const
-    {
-        return m_invoke;
-    }
-
-private:
-    std::shared_ptr<detail::BindStateBase> m_bind_state_ptr;
-    PolymorphicInvoke m_invoke;
-};
-
-template <typename R, typename A1, typename A2, typename A3, typename A4, typename A5>
-class Callback<R(A1, A2, A3, A4, A5)> {
-private:
-    typedef R (*PolymorphicInvoke)(detail::BindStateBase*,
-                                   typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                                   typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                                   typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                                   typename detail::CallbackParamTraits<A4>::ForwardType a4,
-                                   typename detail::CallbackParamTraits<A5>::ForwardType a5);
-
-public:
-    typedef R(RunType)(A1, A2, A3, A4, A5);
-    typedef PolymorphicInvoke unspecified_bool_type;
-
-    Callback() : m_invoke(NULL)
-    {
-    }
-
-    // Should be private, but avoids template friendship issues.
-    template <typename FunctorType, typename RunType, typename BoundArgsType>
-    Callback(detail::BindState<FunctorType, RunType, BoundArgsType>* bind_state)
-        : m_bind_state_ptr(bind_state),
-          m_invoke(&detail::BindState<FunctorType, RunType, BoundArgsType>::InvokerType::invoke)
-    {
-    }
-
-    R operator()(typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                 typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                 typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                 typename detail::CallbackParamTraits<A4>::ForwardType a4,
-                 typename detail::CallbackParamTraits<A5>::ForwardType a5) const
-    {
-        return m_invoke(m_bind_state_ptr.get(), a1, a2, a3, a4, a5);
-    }
-
-    operator unspecified_bool_type() const
-    {
-        return m_invoke;
-    }
-
-private:
-    std::shared_ptr<detail::BindStateBase> m_bind_state_ptr;
-    PolymorphicInvoke m_invoke;
-};
-
-template <typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
-class Callback<R(A1, A2, A3, A4, A5, A6)> {
-private:
-    typedef R (*PolymorphicInvoke)(detail::BindStateBase*,
-                                   typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                                   typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                                   typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                                   typename detail::CallbackParamTraits<A4>::ForwardType a4,
-                                   typename detail::CallbackParamTraits<A5>::ForwardType a5,
-                                   typename detail::CallbackParamTraits<A6>::ForwardType a6);
-
-public:
-    typedef R(RunType)(A1, A2, A3, A4, A5, A6);
-    typedef PolymorphicInvoke unspecified_bool_type;
-
-    Callback() : m_invoke(NULL)
-    {
-    }
-
-    // Should be private, but avoids template friendship issues.
-    template <typename FunctorType, typename RunType, typename BoundArgsType>
-    Callback(detail::BindState<FunctorType, RunType, BoundArgsType>* bind_state)
-        : m_bind_state_ptr(bind_state),
-          m_invoke(&detail::BindState<FunctorType, RunType, BoundArgsType>::InvokerType::invoke)
-    {
-    }
-
-    R operator()(typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                 typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                 typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                 typename detail::CallbackParamTraits<A4>::ForwardType a4,
-                 typename detail::CallbackParamTraits<A5>::ForwardType a5,
-                 typename detail::CallbackParamTraits<A6>::ForwardType a6) const
-    {
-        return m_invoke(m_bind_state_ptr.get(), a1, a2, a3, a4, a5, a6);
-    }
-
-    operator unspecified_bool_type() const
-    {
-        return m_invoke;
-    }
-
-private:
-    std::shared_ptr<detail::BindStateBase> m_bind_state_ptr;
-    PolymorphicInvoke m_invoke;
-};
-
-template <typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
-class Callback<R(A1, A2, A3, A4, A5, A6, A7)> {
-private:
-    typedef R (*PolymorphicInvoke)(detail::BindStateBase*,
-                                   typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                                   typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                                   typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                                   typename detail::CallbackParamTraits<A4>::ForwardType a4,
-                                   typename detail::CallbackParamTraits<A5>::ForwardType a5,
-                                   typename detail::CallbackParamTraits<A6>::ForwardType a6,
-                                   typename detail::CallbackParamTraits<A7>::ForwardType a7);
-
-public:
-    typedef R(RunType)(A1, A2, A3, A4, A5, A6, A7);
-    typedef PolymorphicInvoke unspecified_bool_type;
-
-    Callback() : m_invoke(NULL)
-    {
-    }
-
-    // Should be private, but avoids template friendship issues.
-    template <typename FunctorType, typename RunType, typename BoundArgsType>
-    Callback(detail::BindState<FunctorType, RunType, BoundArgsType>* bind_state)
-        : m_bind_state_ptr(bind_state),
-          m_invoke(&detail::BindState<FunctorType, RunType, BoundArgsType>::InvokerType::invoke)
-    {
-    }
-
-    R operator()(typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                 typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                 typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                 typename detail::CallbackParamTraits<A4>::ForwardType a4,
-                 typename detail::CallbackParamTraits<A5>::ForwardType a5,
-                 typename detail::CallbackParamTraits<A6>::ForwardType a6,
-                 typename detail::CallbackParamTraits<A7>::ForwardType a7) const
-    {
-        return m_invoke(m_bind_state_ptr.get(), a1, a2, a3, a4, a5, a6, a7);
-    }
-
-    operator unspecified_bool_type() const
-    {
-        return m_invoke;
-    }
-
-private:
-    std::shared_ptr<detail::BindStateBase> m_bind_state_ptr;
-    PolymorphicInvoke m_invoke;
-};
-
-template <typename R,
-          typename A1,
-          typename A2,
-          typename A3,
-          typename A4,
-          typename A5,
-          typename A6,
-          typename A7,
-          typename A8>
-class Callback<R(A1, A2, A3, A4, A5, A6, A7, A8)> {
-private:
-    typedef R (*PolymorphicInvoke)(detail::BindStateBase*,
-                                   typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                                   typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                                   typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                                   typename detail::CallbackParamTraits<A4>::ForwardType a4,
-                                   typename detail::CallbackParamTraits<A5>::ForwardType a5,
-                                   typename detail::CallbackParamTraits<A6>::ForwardType a6,
-                                   typename detail::CallbackParamTraits<A7>::ForwardType a7,
-                                   typename detail::CallbackParamTraits<A8>::ForwardType a8);
-
-public:
-    typedef R(RunType)(A1, A2, A3, A4, A5, A6, A7, A8);
-    typedef PolymorphicInvoke unspecified_bool_type;
-
-    Callback() : m_invoke(NULL)
-    {
-    }
-
-    // Should be private, but avoids template friendship issues.
-    template <typename FunctorType, typename RunType, typename BoundArgsType>
-    Callback(detail::BindState<FunctorType, RunType, BoundArgsType>* bind_state)
-        : m_bind_state_ptr(bind_state),
-          m_invoke(&detail::BindState<FunctorType, RunType, BoundArgsType>::InvokerType::invoke)
-    {
-    }
-
-    R operator()(typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                 typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                 typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                 typename detail::CallbackParamTraits<A4>::ForwardType a4,
-                 typename detail::CallbackParamTraits<A5>::ForwardType a5,
-                 typename detail::CallbackParamTraits<A6>::ForwardType a6,
-                 typename detail::CallbackParamTraits<A7>::ForwardType a7,
-                 typename detail::CallbackParamTraits<A8>::ForwardType a8) const
-    {
-        return m_invoke(m_bind_state_ptr.get(), a1, a2, a3, a4, a5, a6, a7, a8);
-    }
-
-    operator unspecified_bool_type() const
-    {
-        return m_invoke;
-    }
-
-private:
-    std::shared_ptr<detail::BindStateBase> m_bind_state_ptr;
-    PolymorphicInvoke m_invoke;
-};
-
-template <typename R,
-          typename A1,
-          typename A2,
-          typename A3,
-          typename A4,
-          typename A5,
-          typename A6,
-          typename A7,
-          typename A8,
-          typename A9>
-class Callback<R(A1, A2, A3, A4, A5, A6, A7, A8, A9)> {
-private:
-    typedef R (*PolymorphicInvoke)(detail::BindStateBase*,
-                                   typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                                   typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                                   typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                                   typename detail::CallbackParamTraits<A4>::ForwardType a4,
-                                   typename detail::CallbackParamTraits<A5>::ForwardType a5,
-                                   typename detail::CallbackParamTraits<A6>::ForwardType a6,
-                                   typename detail::CallbackParamTraits<A7>::ForwardType a7,
-                                   typename detail::CallbackParamTraits<A8>::ForwardType a8,
-                                   typename detail::CallbackParamTraits<A9>::ForwardType a9);
-
-public:
-    typedef R(RunType)(A1, A2, A3, A4, A5, A6, A7, A8, A9);
-    typedef PolymorphicInvoke unspecified_bool_type;
-
-    Callback() : m_invoke(NULL)
-    {
-    }
-
-    // Should be private, but avoids template friendship issues.
-    template <typename FunctorType, typename RunType, typename BoundArgsType>
-    Callback(detail::BindState<FunctorType, RunType, BoundArgsType>* bind_state)
-        : m_bind_state_ptr(bind_state),
-          m_invoke(&detail::BindState<FunctorType, RunType, BoundArgsType>::InvokerType::invoke)
-    {
-    }
-
-    R operator()(typename detail::CallbackParamTraits<A1>::ForwardType a1,
-                 typename detail::CallbackParamTraits<A2>::ForwardType a2,
-                 typename detail::CallbackParamTraits<A3>::ForwardType a3,
-                 typename detail::CallbackParamTraits<A4>::ForwardType a4,
-                 typename detail::CallbackParamTraits<A5>::ForwardType a5,
-                 typename detail::CallbackParamTraits<A6>::ForwardType a6,
-                 typename detail::CallbackParamTraits<A7>::ForwardType a7,
-                 typename detail::CallbackParamTraits<A8>::ForwardType a8,
-                 typename detail::CallbackParamTraits<A9>::ForwardType a9) const
-    {
-        return m_invoke(m_bind_state_ptr.get(), a1, a2, a3, a4, a5, a6, a7, a8, a9);
-    }
-
-    operator unspecified_bool_type() const
-    {
-        return m_invoke;
-    }
-
-private:
-    std::shared_ptr<detail::BindStateBase> m_bind_state_ptr;
-    PolymorphicInvoke m_invoke;
+    detail::CallbackStorage m_storage;
 };
 
 }  // namespace wsd
@@ -1,19 +1,277 @@
 #ifndef __CALLBACK_DETAIL_H__
 #define __CALLBACK_DETAIL_H__
 
+#include <atomic>
+#include <cassert>
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace wsd {
 
 namespace detail {
 
+// A compile-time sequence of indices, used to expand tuples and parameter packs
+// along with their positions.
+template <size_t... Is>
+struct IndexSequence {
+};
+
+template <size_t N, size_t... Is>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, Is...> {
+};
+
+template <size_t... Is>
+struct MakeIndexSequence<0, Is...> {
+    typedef IndexSequence<Is...> type;
+};
+
+// Base of all BindState<> types. It is not polymorphic, to keep bound states small
+// enough to be stored inline in callbacks. The concrete types are destroyed through
+// the operations recorded by CallbackStorage.
 class BindStateBase {
+};
+
+// Storage of the bound state of a callback.
+//
+// Small states are stored inline so that bind() does not allocate memory. A state is
+// small if it fits in kInlineSize bytes and can be copied without throwing, which
+// rules out states holding owned() pointers or types like std::string. Copies of a
+// callback then copy the small state, which is cheap.
+//
+// Other states are allocated on the heap and shared by copies of a callback with an
+// intrusive reference count. The count is atomic because callbacks are copied and
+// destroyed in different threads, e.g. by futures.
+//
+// States of OnceCallback may be move-only. They are stored inline if they can be
+// moved without throwing, and such storages must not be copied.
+//
+// The storage also keeps the invoker of the state, in a type-erased form, so that an
+// empty or moved-from storage is recognized as a null callback.
+class CallbackStorage {
 public:
-    virtual ~BindStateBase()
+    typedef void (*InvokeFuncStorage)();
+
+    struct MoveOnly {
+    };
+
+    static const size_t kInlineSize = 48;
+
+    CallbackStorage() : m_state(NULL), m_ops(NULL), m_invoke(NULL)
+    {
+    }
+
+    template <typename BindState>
+    CallbackStorage(BindState&& state, InvokeFuncStorage invoke) : m_state(NULL), m_ops(NULL), m_invoke(NULL)
+    {
+        typedef typename std::decay<BindState>::type State;
+        init<State>(std::forward<BindState>(state),
+                    std::integral_constant<bool, sizeof(State) <= kInlineSize
+                                                         && alignof(State) <= alignof(Buffer)
+                                                         && std::is_nothrow_copy_constructible<State>::value>());
+        m_invoke = invoke;
+    }
+
+    template <typename BindState>
+    CallbackStorage(MoveOnly, BindState&& state, InvokeFuncStorage invoke)
+        : m_state(NULL), m_ops(NULL), m_invoke(NULL)
+    {
+        typedef typename std::decay<BindState>::type State;
+        init<State>(std::forward<BindState>(state),
+                    std::integral_constant<bool, sizeof(State) <= kInlineSize
+                                                         && alignof(State) <= alignof(Buffer)
+                                                         && std::is_nothrow_move_constructible<State>::value>(),
+                    MoveOnly());
+        m_invoke = invoke;
+    }
+
+    CallbackStorage(const CallbackStorage& other) : m_state(NULL), m_ops(NULL), m_invoke(NULL)
+    {
+        if (other.m_ops) {
+            assert(other.m_ops->copy);
+            other.m_ops->copy(other, this);
+        }
+    }
+
+    CallbackStorage(CallbackStorage&& other) noexcept : m_state(NULL), m_ops(NULL), m_invoke(NULL)
+    {
+        if (other.m_ops) other.m_ops->move(&other, this);
+    }
+
+    CallbackStorage& operator=(const CallbackStorage& other)
+    {
+        if (this != &other) {
+            CallbackStorage tmp(other);
+            reset();
+            if (tmp.m_ops) tmp.m_ops->move(&tmp, this);
+        }
+        return *this;
+    }
+
+    CallbackStorage& operator=(CallbackStorage&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            if (other.m_ops) other.m_ops->move(&other, this);
+        }
+        return *this;
+    }
+
+    ~CallbackStorage()
+    {
+        reset();
+    }
+
+    BindStateBase* get() const
     {
+        return m_state;
     }
+
+    template <typename InvokeFuncType>
+    InvokeFuncType invoker() const
+    {
+        return reinterpret_cast<InvokeFuncType>(m_invoke);
+    }
+
+    bool isInline() const
+    {
+        return m_ops && m_ops->is_inline;
+    }
+
+private:
+    typedef std::aligned_storage<kInlineSize>::type Buffer;
+
+    // Operations on the concrete state type. `to' is empty before copy() and move(),
+    // and `from' is empty after move(). copy() is NULL for inline move-only states.
+    struct Ops {
+        void (*copy)(const CallbackStorage& from, CallbackStorage* to);
+        void (*move)(CallbackStorage* from, CallbackStorage* to);
+        void (*destroy)(CallbackStorage* storage);
+        bool is_inline;
+    };
+
+    template <typename State>
+    struct InlineOps {
+        static void copy(const CallbackStorage& from, CallbackStorage* to)
+        {
+            to->m_state = new (&to->m_buffer) State(*static_cast<State*>(from.m_state));
+            to->m_ops = from.m_ops;
+            to->m_invoke = from.m_invoke;
+        }
+
+        static void move(CallbackStorage* from, CallbackStorage* to)
+        {
+            to->m_state = new (&to->m_buffer) State(std::move(*static_cast<State*>(from->m_state)));
+            to->m_ops = from->m_ops;
+            to->m_invoke = from->m_invoke;
+            destroy(from);
+        }
+
+        static void destroy(CallbackStorage* storage)
+        {
+            static_cast<State*>(storage->m_state)->~State();
+            storage->m_state = NULL;
+            storage->m_ops = NULL;
+            storage->m_invoke = NULL;
+        }
+
+        static const Ops ops;
+        static const Ops move_only_ops;
+    };
+
+    template <typename State>
+    struct HeapState {
+        template <typename BindState>
+        explicit HeapState(BindState&& state) : m_ref_count(1), m_state(std::forward<BindState>(state))
+        {
+        }
+
+        std::atomic<int> m_ref_count;
+        State m_state;
+    };
+
+    template <typename State>
+    struct HeapOps {
+        static void copy(const CallbackStorage& from, CallbackStorage* to)
+        {
+            static_cast<HeapState<State>*>(from.m_heap_state)->m_ref_count.fetch_add(1, std::memory_order_relaxed);
+            to->m_heap_state = from.m_heap_state;
+            to->m_state = from.m_state;
+            to->m_ops = from.m_ops;
+            to->m_invoke = from.m_invoke;
+        }
+
+        static void move(CallbackStorage* from, CallbackStorage* to)
+        {
+            to->m_heap_state = from->m_heap_state;
+            to->m_state = from->m_state;
+            to->m_ops = from->m_ops;
+            to->m_invoke = from->m_invoke;
+            from->m_state = NULL;
+            from->m_ops = NULL;
+            from->m_invoke = NULL;
+        }
+
+        static void destroy(CallbackStorage* storage)
+        {
+            HeapState<State>* heap_state = static_cast<HeapState<State>*>(storage->m_heap_state);
+            if (heap_state->m_ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) delete heap_state;
+            storage->m_state = NULL;
+            storage->m_ops = NULL;
+            storage->m_invoke = NULL;
+        }
+
+        static const Ops ops;
+    };
+
+    template <typename State, typename BindState>
+    void init(BindState&& state, std::true_type /*is_inline*/)
+    {
+        m_state = new (&m_buffer) State(std::forward<BindState>(state));
+        m_ops = &InlineOps<State>::ops;
+    }
+
+    template <typename State, typename BindState>
+    void init(BindState&& state, std::true_type /*is_inline*/, MoveOnly)
+    {
+        m_state = new (&m_buffer) State(std::forward<BindState>(state));
+        m_ops = &InlineOps<State>::move_only_ops;
+    }
+
+    template <typename State, typename BindState>
+    void init(BindState&& state, std::false_type /*is_inline*/, MoveOnly = MoveOnly())
+    {
+        HeapState<State>* heap_state = new HeapState<State>(std::forward<BindState>(state));
+        m_heap_state = heap_state;
+        m_state = &heap_state->m_state;
+        m_ops = &HeapOps<State>::ops;
+    }
+
+    void reset()
+    {
+        if (m_ops) m_ops->destroy(this);
+    }
+
+    union {
+        Buffer m_buffer;     // the inline state
+        void* m_heap_state;  // HeapState<>
+    };
+    BindStateBase* m_state;      // points into m_buffer or *m_heap_state
+    const Ops* m_ops;            // NULL if empty
+    InvokeFuncStorage m_invoke;  // NULL if empty
 };
 
+template <typename State>
+const CallbackStorage::Ops CallbackStorage::InlineOps<State>::ops = {&copy, &move, &destroy, true};
+
+template <typename State>
+const CallbackStorage::Ops CallbackStorage::InlineOps<State>::move_only_ops = {NULL, &move, &destroy, true};
+
+template <typename State>
+const CallbackStorage::Ops CallbackStorage::HeapOps<State>::ops = {&copy, &move, &destroy, false};
+
 // This is a typetraits object that's used to take an argument type, and
 // extract a suitable type for storing and forwarding arguments.
 template <typename T>
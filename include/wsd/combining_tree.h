@@ -6,29 +6,414 @@
 
 #pragma once
 
-#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <mutex>
-#include <condition_variable>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "wsd/asymmetric_fence.h"
+#include "wsd/detail/cache_line.h"
+#include "wsd/detail/thread_slots.h"
+#include "wsd/detail/waiters.h"
 
 namespace wsd {
 
+// A software combining tree applying an associative operation to a shared value,
+// e.g. adding to a counter, or taking the max. Threads climbing the tree pair up at
+// its nodes, and one thread of each pair carries the combined operand of both up,
+// so that the root is updated by far fewer threads than call GetAndApply().
+//
+// `Op' only needs to be associative: the operand of the thread arriving first at a
+// node is applied before that of the second one. Each thread gets the value before
+// its own operand is applied, as if the operations were applied one by one.
+//
+//   wsd::CombiningTree<uint64_t> sequence(64);
+//   uint64_t first = sequence.GetAndAdd(16);  // allocates [first, first + 16)
+//
+//   wsd::CombiningTree<uint64_t, Max> high_water_mark(64);
+//   high_water_mark.GetAndApply(latency);
+//
+// The protocol needs at most two threads to start at each leaf, so each thread
+// using the tree gets a slot, recycled when it exits, and slots 2i and 2i + 1 share
+// leaf i. The tree is rebuilt with the value carried over when the threads holding
+// slots no longer fit, or fit in a quarter of the leaves. Rebuilding waits for the
+// operations in progress, which announce themselves in their own slots:
+//
+//   Operation:                         Rebuilding:
+//   slot.busy = true;                  resizing = true;
+//   AsymmetricLightFence();            AsymmetricHeavyFence();
+//   if (!resizing) climb the tree;     wait until no slot is busy;
+//   slot.busy = false;                 rebuild, resizing = false;
+template <typename T, typename Op = std::plus<T>>
 class CombiningTree final {
 public:
-    CombiningTree(int width);
+    // Starts with room for `width' threads, and never gets smaller.
+    explicit CombiningTree(int width, const T& initial = T(), const Op& op = Op())
+        : m_min_capacity(RoundUpToPowerOfTwo(width)),
+          m_op(op),
+          m_layout(new Layout(m_min_capacity, initial, op))
+    {
+    }
 
     CombiningTree(const CombiningTree&) = delete;
     CombiningTree& operator=(const CombiningTree&) = delete;
 
-    ~CombiningTree();
-    
-    int GetAndIncrement();
+    ~CombiningTree()
+    {
+        delete m_layout.load(std::memory_order_relaxed);
+    }
+
+    // Applies `operand' to the value, and returns the value before.
+    T GetAndApply(const T& operand)
+    {
+        detail::ThreadSlots::Slot* slot = m_slots.Get();
+        while (true) {
+            slot->busy.store(true, std::memory_order_relaxed);
+            AsymmetricLightFence();
+            if (!m_resizing.load(std::memory_order_relaxed)) {
+                // Not rebuilt until the slot is idle again.
+                Layout* layout = m_layout.load(std::memory_order_acquire);
+                if (Fits(layout, slot->index)) {
+                    T prior = Climb(layout, slot->index, operand);
+                    slot->busy.store(false, std::memory_order_release);
+                    return prior;
+                }
+            }
+            slot->busy.store(false, std::memory_order_release);
+            Resize();
+        }
+    }
+
+    // Adds `n' at once, e.g. to allocate n numbers of a sequence.
+    T GetAndAdd(const T& n)
+    {
+        static_assert(std::is_same<Op, std::plus<T>>::value, "GetAndAdd() needs std::plus");
+        return GetAndApply(n);
+    }
+
+    T GetAndIncrement()
+    {
+        return GetAndAdd(T(1));
+    }
 
-    int Get();
+    T Get()
+    {
+        std::lock_guard<std::mutex> lock(m_resize_mutex);
+        return m_layout.load(std::memory_order_relaxed)->nodes[0]->Result();
+    }
+
+    // The number of threads the tree has room for now, for tests and tuning.
+    int capacity()
+    {
+        std::lock_guard<std::mutex> lock(m_resize_mutex);
+        return m_layout.load(std::memory_order_relaxed)->capacity;
+    }
 
 private:
     class Node;
-    std::vector<Node*> m_nodes;
-    std::vector<Node*> m_leaf;
+
+    // A complete binary tree in heap order, whose leaves are the last nodes.
+    struct Layout {
+        Layout(int cap, const T& initial, const Op& op) : capacity(cap)
+        {
+            int num_leaves = cap / 2;
+            nodes.push_back(new Node(nullptr, initial, op));
+            for (int i = 1; i < 2 * num_leaves - 1; ++i) {
+                nodes.push_back(new Node(nodes[(i-1)/2], initial, op));
+            }
+            leaves = &nodes[num_leaves - 1];
+        }
+
+        ~Layout()
+        {
+            for (auto* p : nodes) {
+                delete p;
+            }
+        }
+
+        const int capacity;  // threads, twice the leaves
+        std::vector<Node*> nodes;
+        Node* const* leaves;
+    };
+
+    static int RoundUpToPowerOfTwo(int n)
+    {
+        int size = 2;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    // Returns true if the tree is the right size for the threads holding slots.
+    bool Fits(const Layout* layout, int index) const
+    {
+        if (index >= layout->capacity) {
+            return false;
+        }
+        return layout->capacity == m_min_capacity || m_slots.limit() * 4 > layout->capacity;
+    }
+
+    T Climb(Layout* layout, int index, const T& operand)
+    {
+        Node* my_leaf = layout->leaves[index/2];
+        Node* node = my_leaf;
+        while (node->PreCombine()) {
+            node = node->Parent();
+        }
+        Node* stop = node;
+
+        // The path is at most as long as the number of bits of the capacity.
+        Node* path[sizeof(int) * 8];
+        size_t depth = 0;
+        node = my_leaf;
+        T combined = operand;
+        while (node != stop) {
+            combined = node->Combine(combined);
+            path[depth++] = node;
+            node = node->Parent();
+        }
+
+        T prior = stop->Apply(combined);
+
+        while (depth > 0) {
+            path[--depth]->Distribute(prior);
+        }
+        return prior;
+    }
+
+    // Rebuilds the tree if it does not fit the threads holding slots, or waits for
+    // the thread rebuilding it.
+    void Resize()
+    {
+        std::lock_guard<std::mutex> lock(m_resize_mutex);
+        Layout* layout = m_layout.load(std::memory_order_relaxed);
+        int limit = m_slots.limit();
+        if (Fits(layout, limit > 0 ? limit - 1 : 0)) {
+            return;
+        }
+        m_resizing.store(true, std::memory_order_relaxed);
+        AsymmetricHeavyFence();
+        m_slots.ForEachHeld([](detail::ThreadSlots::Slot* slot) {
+            for (int i = 0; slot->busy.load(std::memory_order_acquire); ++i) {
+                if (i >= 64) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        // Slots can not be taken while waiting, but may have been released before.
+        int capacity = std::max(m_min_capacity, RoundUpToPowerOfTwo(m_slots.limit()));
+        std::unique_ptr<Layout> resized(new Layout(capacity, layout->nodes[0]->Result(), m_op));
+        m_layout.store(resized.release(), std::memory_order_release);
+        delete layout;
+        m_resizing.store(false, std::memory_order_release);
+    }
+
+    const int m_min_capacity;
+    const Op m_op;
+    detail::ThreadSlots m_slots;
+    std::atomic<Layout*> m_layout;
+    std::atomic<bool> m_resizing{false};
+    std::mutex m_resize_mutex;  // held while rebuilding
 };
-    
+
+// The node protocol is that of Herlihy and Shavit, with the node mutex replaced by a
+// spin lock, since critical sections are a few loads and stores, and the condition
+// waits replaced by spinning before parking: the partner being waited for is usually
+// a few hundred cycles away, so parking is a rare slow path, and nodes with nobody
+// parked are notified with a fence and a load rather than a system call.
+template <typename T, typename Op>
+class CombiningTree<T, Op>::Node {
+public:
+    // The root if `parent' is null.
+    Node(Node* parent, const T& initial, const Op& op)
+        : m_status(parent ? IDLE : ROOT),
+          m_first_value(initial),
+          m_second_value(initial),
+          m_result(initial),
+          m_parent(parent),
+          m_op(op)
+    {
+    }
+
+    Node* Parent() const
+    {
+        return m_parent;
+    }
+
+    bool PreCombine()
+    {
+        Lock();
+        WaitUntilUnlocked();
+
+        switch (m_status.load(std::memory_order_relaxed)) {
+        case IDLE:
+            m_status.store(FIRST, std::memory_order_relaxed);
+            Unlock();
+            return true;
+        case FIRST:
+            m_locked.store(true, std::memory_order_relaxed);
+            m_status.store(SECOND, std::memory_order_relaxed);
+            Unlock();
+            return false;
+        case ROOT:
+            Unlock();
+            return false;
+        default:
+            Unlock();
+            throw std::logic_error("unexpected Node status");
+        }
+    }
+
+    T Combine(const T& combined)
+    {
+        Lock();
+        WaitUntilUnlocked();
+        m_locked.store(true, std::memory_order_relaxed);
+        m_first_value = combined;
+        Status status = m_status.load(std::memory_order_relaxed);
+        T second_value = m_second_value;
+        Unlock();
+        switch (status) {
+        case FIRST:
+            return combined;
+        case SECOND:
+            return m_op(combined, second_value);
+        default:
+            throw std::logic_error("unexpected Node status");
+        }
+    }
+
+    T Apply(const T& combined)
+    {
+        Lock();
+        switch (m_status.load(std::memory_order_relaxed)) {
+        case ROOT: {
+            T prior = m_result;
+            m_result = m_op(m_result, combined);
+            Unlock();
+            return prior;
+        }
+        case SECOND: {
+            m_second_value = combined;
+            m_locked.store(false, std::memory_order_relaxed);
+            UnlockAndNotify();
+            Lock();
+            WaitUntil([this]() { return m_status.load(std::memory_order_relaxed) == RESULT; });
+            m_locked.store(false, std::memory_order_relaxed);
+            m_status.store(IDLE, std::memory_order_relaxed);
+            T result = m_result;
+            UnlockAndNotify();
+            return result;
+        }
+        default:
+            Unlock();
+            throw std::logic_error("unexpected Node status");
+        }
+    }
+
+    void Distribute(const T& prior)
+    {
+        Lock();
+        switch (m_status.load(std::memory_order_relaxed)) {
+        case FIRST:
+            m_status.store(IDLE, std::memory_order_relaxed);
+            m_locked.store(false, std::memory_order_relaxed);
+            break;
+        case SECOND:
+            m_result = m_op(prior, m_first_value);
+            m_status.store(RESULT, std::memory_order_relaxed);
+            break;
+        default:
+            Unlock();
+            throw std::logic_error("unexpected Node status");
+        }
+        UnlockAndNotify();
+    }
+
+    T Result()
+    {
+        Lock();
+        T result = m_result;
+        Unlock();
+        return result;
+    }
+
+private:
+    enum Status {
+        IDLE, FIRST, SECOND, RESULT, ROOT
+    };
+
+    static constexpr int kSpinsBeforeYield = 64;
+    static constexpr int kSpinsBeforePark = 1024;
+
+    void Lock()
+    {
+        int spins = 0;
+        while (m_spin_lock.exchange(true, std::memory_order_acquire)) {
+            while (m_spin_lock.load(std::memory_order_relaxed)) {
+                // The holder may have been preempted.
+                if (++spins > kSpinsBeforeYield) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+
+    void Unlock()
+    {
+        m_spin_lock.store(false, std::memory_order_release);
+    }
+
+    // Called after changing m_locked or m_status, which threads may wait for.
+    void UnlockAndNotify()
+    {
+        Unlock();
+        m_waiters.Notify();
+    }
+
+    void WaitUntilUnlocked()
+    {
+        WaitUntil([this]() { return !m_locked.load(std::memory_order_relaxed); });
+    }
+
+    // Called and returns with the spin lock held, which is released while waiting.
+    template <typename Predicate>
+    void WaitUntil(Predicate ready)
+    {
+        while (!ready()) {
+            Unlock();
+            for (int i = 0; i < kSpinsBeforePark && !ready(); ++i) {
+                if (i >= kSpinsBeforeYield) {
+                    std::this_thread::yield();
+                }
+            }
+            if (!ready()) {
+                m_waiters.Wait(ready);
+            }
+            Lock();
+        }
+    }
+
+    // Written by the threads combining at this node, so kept off the cache lines of
+    // other nodes by the padding below.
+    std::atomic<bool> m_spin_lock{false};
+    std::atomic<bool> m_locked{false};
+    std::atomic<Status> m_status;
+    T m_first_value;
+    T m_second_value;
+    T m_result;
+    Node* const m_parent;
+    const Op m_op;
+    detail::Waiters m_waiters;  // threads parked in WaitUntil()
+    char m_pad[detail::kCacheLineSize];
+};
+
 }  // namespace wsd
@@ -0,0 +1,479 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#ifndef __COROUTINE_H__
+#define __COROUTINE_H__
+
+// C++20 coroutine support for futures. Everything here is only available when the
+// compiler supports coroutines; the rest of the library keeps building with C++11.
+//
+// Example:
+//
+//     wsd::Task<int> fetchLength(const std::string& url)
+//     {
+//         std::string body = co_await httpGet(url);  // httpGet() returns Future<std::string>
+//         co_return body.size();
+//     }
+//
+//     wsd::Task<int> fetchAll()
+//     {
+//         int n = co_await fetchLength("a");  // resumes fetchLength() directly
+//         co_return n + co_await fetchLength("b");
+//     }
+//
+//     wsd::Future<int> f = wsd::toFuture(fetchAll(), &executor);
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "bind.h"
+#include "promise.h"
+
+namespace wsd {
+
+/**
+ * Where coroutines are resumed. A Task resumes on the executor it runs on after
+ * awaiting futures or tasks, no matter which thread satisfies them. Without an
+ * executor, a coroutine is resumed in the thread satisfying the awaited future.
+ */
+class Executor {
+public:
+    virtual ~Executor()
+    {
+    }
+
+    /**
+     * Resumes `handle' later, usually in another thread.
+     */
+    virtual void execute(std::coroutine_handle<> handle) = 0;
+};
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+template <typename T>
+struct is_task_type : std::false_type {
+};
+
+template <typename T>
+struct is_task_type<Task<T>> : std::true_type {
+};
+
+// An eagerly started coroutine which destroys itself when done, used to bridge
+// tasks to futures.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() const noexcept
+        {
+            return {};
+        }
+        std::suspend_never initial_suspend() const noexcept
+        {
+            return {};
+        }
+        std::suspend_never final_suspend() const noexcept
+        {
+            return {};
+        }
+        void return_void() const noexcept
+        {
+        }
+        void unhandled_exception() const noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+template <typename T>
+DetachedTask runTask(Task<T> task, Promise<T> promise, Executor* executor);
+
+// Awaits a future, and resumes the coroutine on `executor' if not null. The
+// registered callback and await_suspend() race to finish; the later one resumes
+// the coroutine, so that a future satisfied during registration does not resume
+// the coroutine inside await_suspend().
+template <typename T>
+class FutureAwaiter {
+public:
+    FutureAwaiter(const Future<T>& future, Executor* executor)
+        : m_future(future), m_executor(executor), m_is_half_done(false)
+    {
+    }
+
+    bool await_ready() const
+    {
+        return m_future.isDone();
+    }
+
+    // \throws std::bad_alloc, or FutureUninitialized if the future is not initialized.
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        m_handle = handle;
+        FutureAccess::registerCallback(m_future, wsd::bind(&FutureAwaiter::on_future, wsd::unretained(this)));
+        return !m_is_half_done.exchange(true, std::memory_order_acq_rel);
+    }
+
+    T await_resume() const
+    {
+        return m_future.get();
+    }
+
+private:
+    void on_future(const std::shared_ptr<FutureObjectInterface<T>>&)
+    {
+        if (!m_is_half_done.exchange(true, std::memory_order_acq_rel)) return;
+        if (m_executor)
+            m_executor->execute(m_handle);
+        else
+            m_handle.resume();
+    }
+
+    Future<T> m_future;
+    Executor* m_executor;
+    std::coroutine_handle<> m_handle;
+    std::atomic<bool> m_is_half_done;
+};
+
+// Switches the coroutine to `executor'.
+class ExecutorAwaiter {
+public:
+    explicit ExecutorAwaiter(Executor& executor) : m_executor(&executor)
+    {
+    }
+
+    bool await_ready() const
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        m_executor->execute(handle);
+    }
+
+    void await_resume() const
+    {
+    }
+
+    Executor* executor() const
+    {
+        return m_executor;
+    }
+
+private:
+    Executor* m_executor;
+};
+
+class TaskPromiseBase {
+public:
+    TaskPromiseBase() : m_executor(nullptr), m_continuation_executor(nullptr)
+    {
+    }
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    // Transfers to the awaiting coroutine directly if it runs on the same executor,
+    // so that a chain of tasks neither grows the stack nor goes through the executor.
+    class FinalAwaiter {
+    public:
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            TaskPromiseBase& promise = handle.promise();
+            if (!promise.m_continuation) return std::noop_coroutine();
+            Executor* executor = promise.m_continuation_executor;
+            if (executor && executor != promise.m_executor) {
+                executor->execute(promise.m_continuation);
+                return std::noop_coroutine();
+            }
+            return promise.m_continuation;
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    FinalAwaiter final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception()
+    {
+        m_exception = std::current_exception();
+    }
+
+    template <typename U>
+    FutureAwaiter<U> await_transform(const Future<U>& future)
+    {
+        return FutureAwaiter<U>(future, m_executor);
+    }
+
+    ExecutorAwaiter await_transform(const ExecutorAwaiter& awaiter)
+    {
+        m_executor = awaiter.executor();
+        return awaiter;
+    }
+
+    template <typename U>
+    auto await_transform(Task<U>&& task)
+    {
+        return std::move(task).awaitOn(m_executor);
+    }
+
+    template <typename Awaitable,
+              typename = typename std::enable_if<!is_future_type<typename std::decay<Awaitable>::type>::value
+                                                 && !is_task_type<typename std::decay<Awaitable>::type>::value
+                                                 && !std::is_same<typename std::decay<Awaitable>::type,
+                                                                  ExecutorAwaiter>::value>::type>
+    Awaitable&& await_transform(Awaitable&& awaitable)
+    {
+        return std::forward<Awaitable>(awaitable);
+    }
+
+    void setExecutor(Executor* executor)
+    {
+        m_executor = executor;
+    }
+
+    void setContinuation(std::coroutine_handle<> continuation, Executor* executor)
+    {
+        m_continuation = continuation;
+        m_continuation_executor = executor;
+    }
+
+protected:
+    std::exception_ptr m_exception;
+
+private:
+    Executor* m_executor;
+    std::coroutine_handle<> m_continuation;
+    Executor* m_continuation_executor;
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    Task<T> get_return_object();
+
+    template <typename U>
+    void return_value(U&& value)
+    {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    T getResult()
+    {
+        if (m_exception) std::rethrow_exception(m_exception);
+        return std::move(*m_value);
+    }
+
+private:
+    std::optional<T> m_value;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object();
+
+    void return_void() const
+    {
+    }
+
+    void getResult()
+    {
+        if (m_exception) std::rethrow_exception(m_exception);
+    }
+};
+
+template <typename T>
+class TaskAwaiter {
+public:
+    explicit TaskAwaiter(std::coroutine_handle<TaskPromise<T>> handle, Executor* executor)
+        : m_handle(handle), m_executor(executor)
+    {
+    }
+
+    bool await_ready() const
+    {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation)
+    {
+        m_handle.promise().setContinuation(continuation, m_executor);
+        return m_handle;
+    }
+
+    T await_resume()
+    {
+        return m_handle.promise().getResult();
+    }
+
+private:
+    std::coroutine_handle<TaskPromise<T>> m_handle;
+    Executor* m_executor;
+};
+
+}  // namespace detail
+
+/**
+ * A lazily started coroutine producing a T. The coroutine starts when the task is
+ * awaited by another coroutine, or when it is passed to toFuture(). An awaited task
+ * runs on the executor of the awaiting task, and resumes the awaiting task directly
+ * when done (symmetric transfer), without going through futures and callbacks.
+ *
+ * In a Task, futures, tasks and switchTo() can be awaited.
+ */
+template <typename T>
+class Task {
+public:
+    typedef detail::TaskPromise<T> promise_type;
+
+    Task() = default;
+
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            if (m_handle) m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task()
+    {
+        if (m_handle) m_handle.destroy();
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool valid() const
+    {
+        return static_cast<bool>(m_handle);
+    }
+
+    detail::TaskAwaiter<T> operator co_await() &&
+    {
+        return std::move(*this).awaitOn(nullptr);
+    }
+
+private:
+    friend class detail::TaskPromise<T>;
+    friend class detail::TaskPromiseBase;
+    template <typename U>
+    friend detail::DetachedTask detail::runTask(Task<U> task, Promise<U> promise, Executor* executor);
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle)
+    {
+    }
+
+    // The task inherits the executor of the awaiting coroutine. The frame is still
+    // owned by this task, which lives until the co_await expression completes.
+    detail::TaskAwaiter<T> awaitOn(Executor* executor) &&
+    {
+        m_handle.promise().setExecutor(executor);
+        return detail::TaskAwaiter<T>(m_handle, executor);
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object()
+{
+    return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object()
+{
+    return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+template <typename T>
+DetachedTask runTask(Task<T> task, Promise<T> promise, Executor* executor)
+{
+    std::exception_ptr e;
+    try {
+        if (executor) co_await ExecutorAwaiter(*executor);
+        if constexpr (std::is_void<T>::value) {
+            co_await std::move(task).awaitOn(executor);
+            promise.set();
+        } else {
+            promise.setValue(co_await std::move(task).awaitOn(executor));
+        }
+        co_return;
+    } catch (...) {
+        e = std::current_exception();
+    }
+    promise.setException(e);
+}
+
+}  // namespace detail
+
+/**
+ * Returns an awaitable switching the awaiting task to `executor'. The task keeps
+ * resuming on `executor' afterwards.
+ */
+inline detail::ExecutorAwaiter switchTo(Executor& executor)
+{
+    return detail::ExecutorAwaiter(executor);
+}
+
+/**
+ * Starts `task' on `executor', or in this thread if `executor' is null, and returns
+ * a future satisfied with its result.
+ *
+ * \throws std::bad_alloc if memory is not available.
+ */
+template <typename T>
+Future<T> toFuture(Task<T> task, Executor* executor = nullptr)
+{
+    Promise<T> promise;
+    Future<T> future = promise.getFuture();
+    detail::runTask(std::move(task), std::move(promise), executor);
+    return future;
+}
+
+/**
+ * Makes futures awaitable in any coroutine. The coroutine is resumed in the thread
+ * satisfying the future, or in this thread if the future is already done.
+ */
+template <typename T>
+detail::FutureAwaiter<T> operator co_await(const Future<T>& future)
+{
+    return detail::FutureAwaiter<T>(future, nullptr);
+}
+
+}  // namespace wsd
+
+#endif  // __cpp_impl_coroutine
+
+#endif  // __COROUTINE_H__
@@ -0,0 +1,132 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+// Counting networks, which spread tokens over output wires with little contention.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "wsd/detail/cache_line.h"
+#include "wsd/detail/layered_network.h"
+
+namespace wsd {
+
+// A network of `width' input and output wires, whose outputs have the step property
+// in any quiescent state: wire i has been taken as many times as wire i + 1, or once
+// more. So the k-th token to leave while no other is in the network leaves on wire
+// k % width, and a counter per output wire makes a counter, see BitonicCounter.
+//
+// The networks trade depth for contention differently: Bitonic is the shallowest of
+// the balancing networks, Periodic is deeper but made of identical blocks, and
+// DiffractingTree lets pairs of tokens pass its balancers without toggling them.
+class CountingNetwork {
+public:
+    virtual ~CountingNetwork()
+    {
+    }
+
+    // Returns the output wire of a token entering on wire `input', which should be
+    // spread over the threads to spread contention, e.g. ThreadId() % width().
+    virtual int Traverse(int input) = 0;
+
+    virtual int width() const = 0;
+};
+
+// The periodic counting network of Dowd, Perl, Rudolph and Saks: log(width) identical
+// Block networks in a row, of depth log(width) * log(width), compiled into a
+// detail::LayeredNetwork. The first layer of a Block balances wires i and
+// width - 1 - i, and is followed by a Block on either half.
+class Periodic final : public CountingNetwork {
+public:
+    // `width' is a power of two. Like Bitonic, takes 64 * depth() * width / 2 bytes
+    // for its balancers.
+    explicit Periodic(int width);
+
+    Periodic(const Periodic&) = delete;
+    Periodic& operator=(const Periodic&) = delete;
+
+    int Traverse(int input) override;
+
+    int width() const override
+    {
+        return m_network.width();
+    }
+
+    int depth() const
+    {
+        return m_network.depth();
+    }
+
+private:
+    detail::LayeredNetwork m_network;
+};
+
+// The diffracting tree of Shavit and Zemach: a binary tree of balancers, whose root
+// sends tokens to the left and right subtrees alternately, which lead to the even and
+// odd output wires. In front of each balancer is a prism, an array of exchangers
+// where two tokens meeting are sent one to each side, as if they had toggled the
+// balancer in turn. Under contention most tokens are diffracted, and the balancers at
+// the top of the tree stop being hot spots. The prisms are halved at each level,
+// since half as many tokens get there.
+//
+// Every token enters the root, so the input wire only needs to be valid.
+class DiffractingTree final : public CountingNetwork {
+public:
+    static constexpr int kDefaultPrismWidth = 8;
+    static constexpr int kDefaultSpins = 32;
+
+    // `width' is a power of two. `prism_width' is the number of exchangers at the
+    // root, e.g. half of the threads expected to contend. A token waits for a partner
+    // up to `spins' iterations.
+    explicit DiffractingTree(int width, int prism_width = kDefaultPrismWidth, int spins = kDefaultSpins);
+
+    DiffractingTree(const DiffractingTree&) = delete;
+    DiffractingTree& operator=(const DiffractingTree&) = delete;
+
+    int Traverse(int input) override;
+
+    int width() const override
+    {
+        return m_width;
+    }
+
+    // The tokens diffracted rather than toggling a balancer, for tuning the prisms.
+    uint64_t num_diffracted() const
+    {
+        return m_num_diffracted.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Exchanger {
+        std::atomic<int> state{0};
+        char pad[detail::kCacheLineSize - sizeof(std::atomic<int>)];
+    };
+
+    int PrismWidth(int level) const
+    {
+        return (m_prism_width >> level) > 0 ? (m_prism_width >> level) : 1;
+    }
+
+    // Returns the output of a token diffracted at `node', or -1.
+    int Diffract(int node, int level);
+
+    const int m_width;
+    const int m_depth;
+    const int m_prism_width;
+    const int m_spins;
+    // The nodes in heap order, whose outputs lead to their children, or to the output
+    // wires at the last level.
+    std::unique_ptr<detail::Balancer[]> m_nodes;
+    std::vector<size_t> m_prism_offsets;  // of the prisms of each level
+    std::unique_ptr<Exchanger[]> m_prisms;  // level after level, node after node
+    std::atomic<uint64_t> m_num_diffracted{0};
+};
+
+}  // namespace wsd
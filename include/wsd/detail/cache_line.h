@@ -0,0 +1,21 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#pragma once
+
+#include <cstddef>
+
+namespace wsd {
+namespace detail {
+
+// The size of the cache lines that data written by different threads is kept apart
+// on. Data is padded with it rather than aligned to it, since new does not honor
+// extended alignments before C++17: a padded member is off the lines of its
+// neighbours wherever the object is allocated.
+constexpr size_t kCacheLineSize = 64;
+
+}  // namespace detail
+}  // namespace wsd
@@ -0,0 +1,116 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "wsd/detail/cache_line.h"
+
+namespace wsd {
+namespace detail {
+
+// Sends tokens to its outputs 0 and 1 alternately. Balancers are allocated in arrays,
+// so each one is padded to a cache line of its own, which also holds where its
+// outputs lead.
+class Balancer final {
+public:
+    Balancer() = default;
+
+    Balancer(const Balancer&) = delete;
+    Balancer& operator=(const Balancer&) = delete;
+
+    void Connect(int output, int next)
+    {
+        m_next[output] = next;
+    }
+
+    int next(int output) const
+    {
+        return m_next[output];
+    }
+
+    // Returns the output taken.
+    int Toggle()
+    {
+        // Counting needs no ordering, only the order of the increments of each toggle.
+        return m_toggle.fetch_add(1, std::memory_order_relaxed) & 1;
+    }
+
+    // Returns where the output taken leads.
+    int Traverse()
+    {
+        return m_next[Toggle()];
+    }
+
+private:
+    std::atomic<unsigned> m_toggle{0};
+    int m_next[2] = {0, 0};
+    char m_pad[kCacheLineSize - sizeof(std::atomic<unsigned>) - 2 * sizeof(int)];
+};
+
+// A balancing network compiled into `depth' layers of width / 2 balancers each, kept
+// in one array layer after layer. Between two layers, each wire has a position, and
+// the outputs 0 and 1 of balancer k of a layer are at positions 2k and 2k + 1 after
+// it. A network is built by placing its balancers on the positions of the wires they
+// take, and each balancer holds the indexes of the balancers its outputs lead to, so
+// a token goes straight from one balancer to the next, with no recursion and no
+// other memory touched.
+class LayeredNetwork final {
+public:
+    // Returns n for a width of 2^n. Throws std::invalid_argument if `width' is not a
+    // power of two.
+    static int Log2(int width);
+
+    LayeredNetwork(int width, int depth);
+
+    LayeredNetwork(const LayeredNetwork&) = delete;
+    LayeredNetwork& operator=(const LayeredNetwork&) = delete;
+
+    // Places a balancer in `layer' taking the wires at positions `a' and `b' before it,
+    // and returns the positions of its outputs 0 and 1 after it.
+    std::pair<int, int> Place(int layer, int a, int b);
+
+    // Leads the wires at `positions' after the last layer to the output wires, in order.
+    void Finish(const std::vector<int>& positions);
+
+    int Traverse(int input)
+    {
+        // The index of the next balancer, and that of the output wire after the last one.
+        int next = m_entries[input];
+        for (int i = 0; i < m_depth; ++i) {
+            next = m_balancers[next].Traverse();
+        }
+        return next;
+    }
+
+    int width() const
+    {
+        return m_width;
+    }
+
+    int depth() const
+    {
+        return m_depth;
+    }
+
+private:
+    // Leads the wire at `position' before `layer' to `next'.
+    void Connect(int layer, int position, int next);
+
+    const int m_width;
+    const int m_depth;
+    std::unique_ptr<Balancer[]> m_balancers;
+    std::unique_ptr<int[]> m_entries;  // the first balancer of each input wire
+    std::vector<int> m_sizes;  // balancers placed by layer
+};
+
+}  // namespace detail
+}  // namespace wsd
@@ -0,0 +1,121 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "wsd/detail/cache_line.h"
+
+namespace wsd {
+namespace detail {
+
+// Numbers the threads using an object with small slot indexes, which are recycled
+// when threads exit, so that objects with per-thread state can index it densely.
+// The lowest free index is handed out first, so the indexes in use stay below the
+// number of threads using the object, unless threads holding high ones outlive
+// many others.
+class ThreadSlots final {
+public:
+    struct Slot {
+        explicit Slot(int i) : index(i)
+        {
+        }
+
+        const int index;
+        // Owned by the user of the slots, e.g. to announce an operation in progress.
+        std::atomic<bool> busy{false};
+        // Owned by the user of the slots, and only accessed by the thread holding the
+        // slot, e.g. per-thread state which the next thread getting the slot reuses.
+        void* data = nullptr;
+        char pad[kCacheLineSize];
+    };
+
+    ThreadSlots();
+
+    ThreadSlots(const ThreadSlots&) = delete;
+    void operator=(const ThreadSlots&) = delete;
+
+    ~ThreadSlots();
+
+    // Returns the slot of the current thread, which holds it until it exits. Throws
+    // std::bad_alloc if the thread has no slot and memory is not available.
+    Slot* Get()
+    {
+        if (s_cached_slot.owner_id == m_id) {
+            return s_cached_slot.slot;
+        }
+        return GetSlow();
+    }
+
+    // One more than the highest index held.
+    int limit() const
+    {
+        return m_table->limit.load(std::memory_order_relaxed);
+    }
+
+    // Calls `f' with each slot held, while no thread can get or release a slot.
+    template <typename F>
+    void ForEachHeld(F f)
+    {
+        std::lock_guard<std::mutex> lock(m_table->mutex);
+        for (size_t i = 0; i < m_table->slots.size(); ++i) {
+            if (m_table->held[i]) {
+                f(m_table->slots[i].get());
+            }
+        }
+    }
+
+private:
+    // Shared with the threads holding slots, which release them when they exit, maybe
+    // after the owner is destroyed.
+    struct Table {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Slot>> slots;  // by index, reused
+        std::vector<bool> held;
+        std::atomic<int> limit{0};
+        std::atomic<bool> is_orphaned{false};
+
+        Slot* Acquire();
+
+        void Release(Slot* slot);
+    };
+
+    struct CachedSlot {
+        uint64_t owner_id;
+        Slot* slot;
+    };
+
+    struct HeldSlot {
+        uint64_t owner_id;
+        Slot* slot;
+        std::shared_ptr<Table> table;
+    };
+
+    // The slots held by the current thread, one per owner.
+    struct ThreadRecords {
+        std::vector<HeldSlot> slots;
+
+        ~ThreadRecords();
+    };
+
+    Slot* GetSlow();
+
+    static std::atomic<uint64_t> s_next_id;
+    static thread_local CachedSlot s_cached_slot;
+    static thread_local ThreadRecords s_thread_records;
+
+    const uint64_t m_id;  // unique, unlike addresses of owners
+    const std::shared_ptr<Table> m_table;
+};
+
+}  // namespace detail
+}  // namespace wsd
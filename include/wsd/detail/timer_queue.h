@@ -0,0 +1,133 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#ifndef __TIMER_QUEUE_H__
+#define __TIMER_QUEUE_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "../callback.h"
+#include "../wsd_magic.h"
+
+namespace wsd {
+
+namespace detail {
+
+// A process-wide queue of timers run by a dedicated thread, which is started the
+// first time the queue is used. It is used to implement deadlines of futures.
+//
+// Tasks are run in the timer thread one by one, so they should be short and should
+// not block.
+class TimerQueue {
+public:
+    typedef Callback<void()> Task;
+    typedef std::pair<std::chrono::steady_clock::time_point, uint64_t> Handle;
+
+    static TimerQueue& instance()
+    {
+        static TimerQueue queue;
+        return queue;
+    }
+
+    ~TimerQueue()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_should_quit = true;
+        }
+        m_cond.notify_one();
+        m_thread.join();
+    }
+
+    /**
+     * Schedules `task' to run after `milliseconds'.
+     *
+     * \throws std::bad_alloc if memory is not available.
+     */
+    Handle schedule(int64_t milliseconds, const Task& task)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Handle handle(std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds), m_next_id++);
+        bool is_earliest = m_tasks.empty() || handle < m_tasks.begin()->first;
+        m_tasks.insert(std::make_pair(handle, task));
+        lock.unlock();
+        if (is_earliest) m_cond.notify_one();
+        return handle;
+    }
+
+    /**
+     * Cancels the task if it has not run yet.
+     *
+     * \throws nothing
+     */
+    void cancel(const Handle& handle)
+    {
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::map<Handle, Task>::iterator it = m_tasks.find(handle);
+            if (it == m_tasks.end()) return;
+            // Destroy the task out of the lock.
+            task = it->second;
+            m_tasks.erase(it);
+        }
+    }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(TimerQueue);
+
+    TimerQueue() : m_next_id(0), m_should_quit(false)
+    {
+        m_thread = std::thread(&TimerQueue::run, this);
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_should_quit) {
+            if (m_tasks.empty()) {
+                m_cond.wait(lock);
+                continue;
+            }
+            std::map<Handle, Task>::iterator it = m_tasks.begin();
+            // Copy the deadline, since the task may be cancelled while waiting.
+            std::chrono::steady_clock::time_point deadline = it->first.first;
+            if (std::chrono::steady_clock::now() < deadline) {
+                m_cond.wait_until(lock, deadline);
+                continue;
+            }
+            Task task = it->second;
+            m_tasks.erase(it);
+            lock.unlock();
+            try {
+                task();
+            } catch (...) {
+                // Ignore the exceptions thrown by the task.
+            }
+            task = Task();
+            lock.lock();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;  // notified when an earlier task is added or on quit
+    std::map<Handle, Task> m_tasks;
+    uint64_t m_next_id;
+    bool m_should_quit;
+    std::thread m_thread;
+};
+
+}  // namespace detail
+
+}  // namespace wsd
+
+#endif  // __TIMER_QUEUE_H__
@@ -0,0 +1,70 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include "wsd/asymmetric_fence.h"
+
+namespace wsd {
+namespace detail {
+
+// Blocks threads until a lock-free structure makes progress, e.g. a queue gets an
+// element. Threads making progress only pay a light fence and a load while nobody
+// waits:
+//
+//   Waiter:                            Notifier:
+//   ++num_waiters;                     make progress;
+//   AsymmetricHeavyFence();            AsymmetricLightFence();
+//   check progress, or wait;           if (num_waiters > 0) notify;
+//
+// Either the waiter sees the progress, or the notifier sees the waiter.
+class Waiters final {
+public:
+    Waiters()
+    {
+        // So that notifiers take the fast path from the start.
+        PrepareAsymmetricFences();
+    }
+
+    Waiters(const Waiters&) = delete;
+    void operator=(const Waiters&) = delete;
+
+    // Blocks until `ready' returns true, which is called with a lock held. It should
+    // only check for progress, e.g. not pop an element and notify other Waiters.
+    template <typename Predicate>
+    void Wait(Predicate ready)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_num_waiters.fetch_add(1, std::memory_order_relaxed);
+        AsymmetricHeavyFence();
+        while (!ready()) {
+            m_cond.wait(lock);
+        }
+        m_num_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Called after making progress.
+    void Notify()
+    {
+        AsymmetricLightFence();
+        if (m_num_waiters.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_cond.notify_all();
+        }
+    }
+
+private:
+    std::atomic<int> m_num_waiters{0};
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+};
+
+}  // namespace detail
+}  // namespace wsd
@@ -8,18 +8,84 @@
 #pragma once
 
 #include <atomic>
-#include <functional>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include <assert.h>
 
 #include "boost/checked_delete.hpp"
-#include "boost/thread/tss.hpp"
 
 namespace wsd {
 
+// The intrusive header of objects retired by EbrManager. Objects to retire should
+// derive from it, so that retiring them does not allocate memory.
+class EbrNode {
+protected:
+    EbrNode() = default;
+    ~EbrNode() = default;
+
+private:
+    friend class EbrManager;
+
+    EbrNode* m_ebr_next = nullptr;
+    void (*m_ebr_deleter)(EbrNode*) = nullptr;
+};
+
+// EbrManager implements the three-epoch protocol:
+//
+//   - A thread entering a critical region announces the global epoch it observes
+//     with a store followed by one full fence. Exiting is a release store.
+//   - The global epoch advances from e to e + 1 only when every thread in a critical
+//     region has announced e. So a thread in a critical region lags at most one epoch.
+//   - Retired nodes are buffered by the retiring thread and tagged in batches with
+//     the global epoch read after a full fence. Nodes tagged e are freed once the
+//     epoch is e + 2: by then every critical region that may have seen them is over.
+//
+// The fences of the entering thread and of the thread advancing the epoch guarantee
+// that either the latter sees the announcement, or the former sees the unlinking of
+// the nodes retired before.
+//
+// A thread stalled in a critical region keeps the epoch from advancing, so memory
+// retired meanwhile is never freed. Options::max_unreclaimed_bytes bounds it: once
+// exceeded, threads retiring nodes wait at the end of their outermost critical
+// regions until their retired nodes are freed. The nodes retired by threads which
+// have exited are freed by the background reclaimer, or by the waiting threads.
 class EbrManager final {
 public:
-    EbrManager();
+    static constexpr size_t kDefaultReclaimInterval = 64;
+
+    struct Options {
+        // Tags retired nodes, tries to advance the epoch and reclaims memory every
+        // `reclaim_interval' retires of a thread.
+        size_t reclaim_interval = kDefaultReclaimInterval;
+        // Runs a background thread which advances the epoch and frees the nodes retired
+        // by exited threads at this interval, if positive.
+        int background_reclaim_interval_ms = 0;
+        // Bounds the bytes retired but not freed yet, if positive.
+        size_t max_unreclaimed_bytes = 0;
+    };
+
+    struct Stats {
+        // The nodes retired but not freed yet. Up to `reclaim_interval' nodes retired
+        // by each thread are only counted once tagged.
+        size_t num_unreclaimed = 0;
+        size_t unreclaimed_bytes = 0;
+        uint64_t epoch = 0;
+        // The attempts to advance the epoch which failed since it last advanced. Threads
+        // lag at most one epoch in this protocol, so a stalled critical region shows up
+        // here rather than as a growing epoch gap.
+        uint64_t num_failed_advances = 0;
+    };
+
+    explicit EbrManager(size_t reclaim_interval = kDefaultReclaimInterval);
+
+    // Throws std::system_error if the background reclaimer can not be started.
+    explicit EbrManager(const Options& options);
 
     // Disallow copy and assignment.
     EbrManager(const EbrManager&) = delete;
@@ -27,32 +93,51 @@ public:
 
     ~EbrManager();
 
+    // Critical regions can be nested. Only the outermost ones announce the epoch.
     void EnterCriticalRegion();
 
     void ExitCriticalRegion();
 
+    // Deletes `node' once no thread can access it. T should derive from EbrNode.
     template <typename T>
     void RetireNode(T* node)
     {
-        EbrRecord* p = GetEbrRecForCurrentThread();
-        std::unique_ptr<NodeToRetire> node_to_retire(new NodeToRetire(node));
-        node_to_retire->next = m_retire_list[p->epoch].load(std::memory_order_relaxed);
-        while (!m_retire_list[p->epoch].compare_exchange_weak(node_to_retire->next, node_to_retire.get(),
-                                                              std::memory_order_release, std::memory_order_relaxed))
-            ;
-        node_to_retire.release();
-        Scan();
+        static_assert(std::is_base_of<EbrNode, T>::value, "retired nodes should derive from wsd::EbrNode");
+        EbrNode* header = node;
+        header->m_ebr_deleter = &DoDelete<T>;
+        Retire(header, sizeof(T));
     }
 
+    Stats GetStats() const;
+
 private:
+    // Nodes retired by a thread in an epoch.
+    struct LimboBag {
+        EbrNode* head = nullptr;
+        uint64_t epoch = 0;
+        size_t num_nodes = 0;
+        size_t num_bytes = 0;
+    };
+
     struct EbrRecord {
         std::atomic_flag in_use = ATOMIC_FLAG_INIT;
         EbrRecord* next = nullptr;
+        EbrManager* const manager;
         std::atomic<int> ref_count{0};
-        std::atomic<bool> active{false};
-        std::atomic<int> epoch{0};
-
-        EbrRecord() : ref_count(1), active(true), epoch(0)
+        // (epoch << 1) | 1 in a critical region, or 0.
+        std::atomic<uint64_t> state{0};
+        std::atomic<bool> is_orphaned{false};  // set when the manager is destroyed
+
+        // Only accessed by the thread owning the record.
+        size_t nesting = 0;
+        EbrNode* pending_head = nullptr;  // retired nodes not tagged yet
+        EbrNode* pending_tail = nullptr;
+        size_t num_pending = 0;
+        size_t pending_bytes = 0;
+        LimboBag limbo_bags[3];
+        bool should_wait = false;  // set when retiring beyond max_unreclaimed_bytes
+
+        explicit EbrRecord(EbrManager* mgr) : manager(mgr), ref_count(1), state(0)
         {
         }
 
@@ -63,7 +148,7 @@ private:
 
         void DecRef()
         {
-            int old = ref_count.fetch_sub(1, std::memory_order_relaxed);
+            int old = ref_count.fetch_sub(1, std::memory_order_acq_rel);
             assert(old >= 1);
             if (old <= 1) {
                 delete this;
@@ -72,69 +157,77 @@ private:
     };
 
     template <typename T>
-    static void DoDelete(void* p)
+    static void DoDelete(EbrNode* p)
     {
         boost::checked_delete(static_cast<T*>(p));
     }
 
-    struct NodeToRetire {
-        void* node = nullptr;
-        std::function<void(void*)> deleter;
-        NodeToRetire* next = nullptr;
-
-        template <typename T>
-        NodeToRetire(T* p) : node(p), deleter(&DoDelete<T>)
-        {
-        }
-
-        ~NodeToRetire()
-        {
-            deleter(node);
-        }
+    // The records of the current thread, one per manager it uses.
+    struct ThreadRecords;
 
-        NodeToRetire(const NodeToRetire&) = delete;
+    struct CachedRecord {
+        uint64_t manager_id;
+        EbrRecord* record;
+    };
 
-        NodeToRetire(NodeToRetire&& other) : node(other.node), deleter(std::move(other.deleter))
-        {
-            other.node = nullptr;
-        }
+    friend class EbrGuard;
 
-        void operator=(const NodeToRetire&) = delete;
+    EbrRecord* Enter();
 
-        NodeToRetire& operator=(NodeToRetire&& other)
-        {
-            if (this != &other) {
-                node = other.node;
-                other.node = nullptr;
-                deleter = std::move(other.deleter);
-            }
-            return *this;
-        }
-    };
+    static void Exit(EbrRecord* p);
 
     EbrRecord* AllocateEbrRec();
 
     EbrRecord* GetEbrRecForCurrentThread();
 
-    void Scan();
+    EbrRecord* GetEbrRecSlow();
 
-    void FreeRetireList(int epoch);
+    void Retire(EbrNode* node, size_t size);
 
-    void FreeList(NodeToRetire* head);
+    void TagPending(EbrRecord* p);
+
+    bool TryAdvanceEpoch();
+
+    void Reclaim(EbrRecord* p);
+
+    void FreeBag(LimboBag* bag);
+
+    void WaitForReclaim(EbrRecord* p);
+
+    void ReclaimAbandoned();
+
+    void RunReclaimer();
+
+    static void FreeList(EbrNode* head);
 
     static void RetireEbrRecord(EbrRecord* p);
 
+    static std::atomic<uint64_t> s_next_id;
+    // The record the current thread used last, checked before s_thread_records.
+    static thread_local CachedRecord s_cached_record;
+    static thread_local ThreadRecords s_thread_records;
+
+    const uint64_t m_id;  // unique, unlike addresses of managers
+    const size_t m_reclaim_interval;
+    const size_t m_max_unreclaimed_bytes;
     std::atomic<EbrRecord*> m_head{nullptr};
-    std::atomic<int> m_global_epoch{0};
-    std::atomic<NodeToRetire*> m_retire_list[3]{{nullptr}};
-    boost::thread_specific_ptr<EbrRecord> m_my_ebr_rec{&EbrManager::RetireEbrRecord};
+    std::atomic<uint64_t> m_global_epoch{0};  // increases monotonically
+
+    std::atomic<size_t> m_num_unreclaimed{0};
+    std::atomic<size_t> m_unreclaimed_bytes{0};
+    std::atomic<uint64_t> m_num_failed_advances{0};
+
+    const std::chrono::milliseconds m_background_reclaim_interval;
+    std::mutex m_reclaimer_mutex;
+    std::condition_variable m_reclaimer_cond;  // notified on memory pressure or on quit
+    bool m_should_quit = false;
+    std::thread m_reclaimer;
 };
 
 class EbrGuard final {
 public:
-    EbrGuard(EbrManager& ebr) : m_ebr(ebr)
+    EbrGuard(EbrManager& ebr) : m_record(ebr.Enter())
     {
-        m_ebr.EnterCriticalRegion();
     }
 
     EbrGuard(const EbrGuard&) = delete;
@@ -142,11 +235,11 @@ public:
 
     ~EbrGuard()
     {
-        m_ebr.ExitCriticalRegion();
+        EbrManager::Exit(m_record);
     }
 
 private:
-    EbrManager& m_ebr;
+    EbrManager::EbrRecord* m_record;
 };
 
 }  // namespace wsd
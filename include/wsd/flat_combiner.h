@@ -0,0 +1,254 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+// Flat combining, which runs the operations of many threads on a sequential data
+// structure in batches.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "wsd/detail/cache_line.h"
+#include "wsd/detail/thread_slots.h"
+
+namespace wsd {
+
+namespace detail {
+
+// An operation published by a thread, run by whichever thread combines.
+template <typename DS>
+class FlatCombiningRequest {
+public:
+    virtual void Run(DS& ds) = 0;
+
+protected:
+    ~FlatCombiningRequest() = default;
+};
+
+template <typename DS, typename R, typename F>
+class FlatCombiningCall final : public FlatCombiningRequest<DS> {
+public:
+    explicit FlatCombiningCall(F& f) : m_f(f)
+    {
+    }
+
+    FlatCombiningCall(const FlatCombiningCall&) = delete;
+    void operator=(const FlatCombiningCall&) = delete;
+
+    ~FlatCombiningCall()
+    {
+        if (m_has_result) {
+            reinterpret_cast<R*>(&m_result)->~R();
+        }
+    }
+
+    void Run(DS& ds) override
+    {
+        try {
+            new (&m_result) R(m_f(ds));
+            m_has_result = true;
+        } catch (...) {
+            m_error = std::current_exception();
+        }
+    }
+
+    R Get()
+    {
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+        return std::move(*reinterpret_cast<R*>(&m_result));
+    }
+
+private:
+    F& m_f;
+    typename std::aligned_storage<sizeof(R), alignof(R)>::type m_result;
+    bool m_has_result = false;
+    std::exception_ptr m_error;
+};
+
+template <typename DS, typename F>
+class FlatCombiningCall<DS, void, F> final : public FlatCombiningRequest<DS> {
+public:
+    explicit FlatCombiningCall(F& f) : m_f(f)
+    {
+    }
+
+    FlatCombiningCall(const FlatCombiningCall&) = delete;
+    void operator=(const FlatCombiningCall&) = delete;
+
+    void Run(DS& ds) override
+    {
+        try {
+            m_f(ds);
+        } catch (...) {
+            m_error = std::current_exception();
+        }
+    }
+
+    void Get()
+    {
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+private:
+    F& m_f;
+    std::exception_ptr m_error;
+};
+
+}  // namespace detail
+
+// Wraps a sequential data structure DS for concurrent use. Instead of taking a lock
+// in turn, each thread publishes its operation in its own record and tries to take
+// the lock once. The thread getting it becomes the combiner: it runs the operations
+// of all the records published, while the others spin on their records until their
+// operations are done, or the lock is free again. So the structure stays in the
+// cache of one thread for a whole batch, and the lock is handed over once per batch
+// rather than once per operation.
+//
+//   wsd::FlatCombiner<std::priority_queue<int>> queue;
+//   queue.Apply([](std::priority_queue<int>& q) { q.push(1); });
+//
+// The records form the publication list, which only grows. Each record belongs to a
+// thread slot, which is reused after the thread exits, so the list is as long as
+// the most threads using the combiner at once.
+//
+// Operations are run by other threads, so they should not depend on the calling
+// thread, e.g. on thread_local variables, and should not call Apply() themselves.
+template <typename DS>
+class FlatCombiner final {
+public:
+    template <typename... Args>
+    explicit FlatCombiner(Args&&... args) : m_ds(std::forward<Args>(args)...)
+    {
+    }
+
+    FlatCombiner(const FlatCombiner&) = delete;
+    void operator=(const FlatCombiner&) = delete;
+
+    ~FlatCombiner()
+    {
+        for (Record* p = m_records.load(std::memory_order_relaxed); p;) {
+            Record* q = p;
+            p = p->next;
+            delete q;
+        }
+    }
+
+    // Runs `op' on the structure with exclusive access, maybe in another thread, and
+    // returns what it returns. Rethrows what it throws. Throws std::bad_alloc if the
+    // thread has no record yet and memory is not available.
+    template <typename F>
+    auto Apply(F op) -> decltype(op(std::declval<DS&>()))
+    {
+        typedef decltype(op(std::declval<DS&>())) R;
+        detail::FlatCombiningCall<DS, R, F> call(op);
+        Record* record = GetRecord();
+        record->request = &call;
+        record->pending.store(true, std::memory_order_release);
+        for (int i = 0; record->pending.load(std::memory_order_acquire); ++i) {
+            if (!m_lock.load(std::memory_order_relaxed) && !m_lock.exchange(true, std::memory_order_acquire)) {
+                Combine();
+                m_lock.store(false, std::memory_order_release);
+            } else if (i >= kSpinsBeforeYield) {
+                // The combiner may have been preempted.
+                std::this_thread::yield();
+            }
+        }
+        return call.Get();
+    }
+
+    // The number of publication records, for tests.
+    size_t num_records() const
+    {
+        size_t n = 0;
+        for (Record* p = m_records.load(std::memory_order_acquire); p; p = p->next) {
+            ++n;
+        }
+        return n;
+    }
+
+    // The average operations run by a combiner, for tuning.
+    double average_batch_size() const
+    {
+        uint64_t n = m_num_combinings.load(std::memory_order_relaxed);
+        return n == 0 ? 0 : static_cast<double>(m_num_combined.load(std::memory_order_relaxed)) / n;
+    }
+
+private:
+    static constexpr int kSpinsBeforeYield = 64;
+    // Passes over the publication list per combining, which pick up the operations
+    // published meanwhile.
+    static constexpr int kMaxPasses = 4;
+
+    struct Record {
+        std::atomic<bool> pending{false};
+        detail::FlatCombiningRequest<DS>* request = nullptr;
+        Record* next = nullptr;  // not modified once published
+        char pad[detail::kCacheLineSize];
+    };
+
+    Record* GetRecord()
+    {
+        detail::ThreadSlots::Slot* slot = m_slots.Get();
+        if (!slot->data) {
+            Record* record = new Record();
+            Record* head = m_records.load(std::memory_order_relaxed);
+            do {
+                record->next = head;
+            } while (!m_records.compare_exchange_weak(head, record, std::memory_order_release,
+                                                      std::memory_order_relaxed));
+            slot->data = record;
+        }
+        return static_cast<Record*>(slot->data);
+    }
+
+    void Combine()
+    {
+        uint64_t num_combined = 0;
+        for (int pass = 0; pass < kMaxPasses; ++pass) {
+            uint64_t n = 0;
+            for (Record* p = m_records.load(std::memory_order_acquire); p; p = p->next) {
+                if (p->pending.load(std::memory_order_acquire)) {
+                    p->request->Run(m_ds);
+                    // The request may be gone once this is seen.
+                    p->pending.store(false, std::memory_order_release);
+                    ++n;
+                }
+            }
+            num_combined += n;
+            if (n == 0) {
+                break;
+            }
+        }
+        m_num_combined.fetch_add(num_combined, std::memory_order_relaxed);
+        m_num_combinings.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    DS m_ds;
+    detail::ThreadSlots m_slots;
+    std::atomic<Record*> m_records{nullptr};
+    char m_pad[detail::kCacheLineSize];
+    std::atomic<bool> m_lock{false};
+    std::atomic<uint64_t> m_num_combined{0};
+    std::atomic<uint64_t> m_num_combinings{0};
+};
+
+template <typename DS>
+constexpr int FlatCombiner<DS>::kSpinsBeforeYield;
+
+template <typename DS>
+constexpr int FlatCombiner<DS>::kMaxPasses;
+
+}  // namespace wsd
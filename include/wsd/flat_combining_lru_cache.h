@@ -0,0 +1,131 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include "wsd/flat_combiner.h"
+
+namespace wsd {
+
+namespace detail {
+
+// A sequential LRU cache: a list from the most to the least recently used entry,
+// indexed by a hash map.
+template <typename K, typename V, typename Hash>
+class LruCache final {
+public:
+    explicit LruCache(size_t capacity) : m_capacity(capacity > 0 ? capacity : 1)
+    {
+    }
+
+    bool Get(const K& key, V* value)
+    {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) {
+            return false;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        *value = it->second->second;
+        return true;
+    }
+
+    void Put(const K& key, const V& value)
+    {
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            it->second->second = value;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return;
+        }
+        m_entries.emplace_front(key, value);
+        try {
+            m_index.emplace(key, m_entries.begin());
+        } catch (...) {
+            m_entries.pop_front();
+            throw;
+        }
+        if (m_entries.size() > m_capacity) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    }
+
+    bool Erase(const K& key)
+    {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) {
+            return false;
+        }
+        m_entries.erase(it->second);
+        m_index.erase(it);
+        return true;
+    }
+
+    size_t size() const
+    {
+        return m_entries.size();
+    }
+
+private:
+    typedef std::list<std::pair<K, V>> List;
+
+    const size_t m_capacity;
+    List m_entries;
+    std::unordered_map<K, typename List::iterator, Hash> m_index;
+};
+
+}  // namespace detail
+
+// An LRU cache shared by many threads. Even a lookup moves the entry to the front
+// of the list, so every operation writes and a read-write lock does not help; with
+// flat combining, a batch of operations is run by one thread with the list in its
+// cache. Holds at most `capacity' entries, evicting the least recently used.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class FlatCombiningLruCache final {
+public:
+    explicit FlatCombiningLruCache(size_t capacity) : m_cache(capacity)
+    {
+    }
+
+    FlatCombiningLruCache(const FlatCombiningLruCache&) = delete;
+    void operator=(const FlatCombiningLruCache&) = delete;
+
+    // Copies the value of `key' into `value' and marks it used. Returns false if
+    // `key' is not cached.
+    bool Get(const K& key, V* value)
+    {
+        return m_cache.Apply([&key, value](Cache& cache) { return cache.Get(key, value); });
+    }
+
+    void Put(const K& key, const V& value)
+    {
+        m_cache.Apply([&key, &value](Cache& cache) { cache.Put(key, value); });
+    }
+
+    // Returns false if `key' is not cached.
+    bool Erase(const K& key)
+    {
+        return m_cache.Apply([&key](Cache& cache) { return cache.Erase(key); });
+    }
+
+    size_t size()
+    {
+        return m_cache.Apply([](Cache& cache) { return cache.size(); });
+    }
+
+private:
+    typedef detail::LruCache<K, V, Hash> Cache;
+
+    FlatCombiner<Cache> m_cache;
+};
+
+}  // namespace wsd
@@ -0,0 +1,66 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "wsd/flat_combiner.h"
+
+namespace wsd {
+
+// A priority queue shared by many threads. Every operation changes the top of the
+// heap, so the heap is a hot spot however it is locked; with flat combining, a batch
+// of operations is run by one thread with the heap in its cache.
+template <typename T, typename Compare = std::less<T>>
+class FlatCombiningPriorityQueue final {
+public:
+    explicit FlatCombiningPriorityQueue(const Compare& compare = Compare()) : m_queue(compare)
+    {
+    }
+
+    FlatCombiningPriorityQueue(const FlatCombiningPriorityQueue&) = delete;
+    void operator=(const FlatCombiningPriorityQueue&) = delete;
+
+    void Push(const T& value)
+    {
+        m_queue.Apply([&value](Queue& queue) { queue.push(value); });
+    }
+
+    void Push(T&& value)
+    {
+        m_queue.Apply([&value](Queue& queue) { queue.push(std::move(value)); });
+    }
+
+    // Copies the greatest value into `value' and removes it. Returns false if the queue is empty.
+    bool TryPop(T* value)
+    {
+        return m_queue.Apply([value](Queue& queue) -> bool {
+            if (queue.empty()) {
+                return false;
+            }
+            *value = queue.top();
+            queue.pop();
+            return true;
+        });
+    }
+
+    size_t size()
+    {
+        return m_queue.Apply([](Queue& queue) { return queue.size(); });
+    }
+
+private:
+    typedef std::priority_queue<T, std::vector<T>, Compare> Queue;
+
+    FlatCombiner<Queue> m_queue;
+};
+
+}  // namespace wsd
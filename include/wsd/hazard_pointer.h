@@ -8,13 +8,17 @@
 
 #include <atomic>
 #include <boost/checked_delete.hpp>
-#include <boost/thread/tss.hpp>
 #include <cassert>
-#include <functional>
-#include <list>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+#include "wsd/asymmetric_fence.h"
+
 namespace wsd {
 
 class HazardManager final {
@@ -25,42 +29,40 @@ private:
         boost::checked_delete(static_cast<T*>(p));
     }
 
+    // Trivially copyable, so that retiring a node only appends to a vector.
     struct NodeToRetire {
         void* node;
-        std::function<void(void*)> deleter;
-
-        template <typename T>
-        NodeToRetire(T* p) : node(p), deleter(&DoDelete<T>)
-        {
-        }
-
-        ~NodeToRetire()
-        {
-            deleter(node);
-        }
-
-        NodeToRetire(const NodeToRetire&) = delete;
-
-        NodeToRetire(NodeToRetire&& other) : node(other.node), deleter(std::move(other.deleter))
-        {
-            other.node = nullptr;
-        }
+        void (*deleter)(void*);
+        size_t size;
+    };
 
-        void operator=(const NodeToRetire&) = delete;
+public:
+    // A stalled reader keeps at most its hazard pointers from being freed, so the
+    // memory retired is bounded by the scan threshold of each running thread, twice the
+    // hazard pointers of the running threads. The nodes retired by threads which have
+    // exited are freed only when other threads scan, though.
+    struct Options {
+        // Runs a background thread which frees the nodes retired by exited threads at
+        // this interval, if positive.
+        int background_reclaim_interval_ms = 0;
+        // Retiring nodes beyond this scans before the threshold is reached, if positive.
+        size_t max_unreclaimed_bytes = 0;
+    };
 
-        NodeToRetire& operator=(NodeToRetire&& other)
-        {
-            if (this != &other) {
-                node = other.node;
-                other.node = nullptr;
-                deleter = std::move(other.deleter);
-            }
-            return *this;
-        }
+    struct Stats {
+        // The nodes retired but not freed yet. Those retired since the last scan of
+        // each thread are counted on the next one.
+        size_t num_unreclaimed = 0;
+        size_t unreclaimed_bytes = 0;
+        // The hazard pointers of the running threads.
+        size_t num_live_slots = 0;
     };
 
-public:
-    HazardManager(int max_hp);
+    // Each thread starts with `num_slots' hazard pointers, and gets more on demand.
+    HazardManager(int num_slots);
+
+    // Throws std::system_error if the background reclaimer can not be started.
+    HazardManager(int num_slots, const Options& options);
 
     ~HazardManager();
 
@@ -68,13 +70,19 @@ public:
     void RetireNode(T* node)
     {
         HPRecType* hp_rec = GetHpRecForCurrentThread();
-        hp_rec->retire_list.emplace_back(node);
-        if (hp_rec->retire_list.size() >= 2 * m_len.load()) {
-            Scan();
-            HelpScan();
+        hp_rec->retire_list.push_back(NodeToRetire{node, &DoDelete<T>, sizeof(T)});
+        ++hp_rec->num_uncounted;
+        hp_rec->uncounted_bytes += sizeof(T);
+        if (hp_rec->retire_list.size() >= hp_rec->scan_threshold ||
+            (m_max_unreclaimed_bytes > 0 &&
+             hp_rec->uncounted_bytes + m_unreclaimed_bytes.load(std::memory_order_relaxed) > m_max_unreclaimed_bytes)) {
+            Scan(hp_rec);
+            HelpScan(hp_rec);
         }
     }
 
+    Stats GetStats() const;
+
     int TEST_GetNumberOfHp() const;
 
     bool TEST_HpListContains(void* p) const;
@@ -84,18 +92,79 @@ public:
     int TEST_GetRetireListLenOfCurrentThread() const;
 
 private:
+    // Hazard pointers are allocated in blocks, which are appended when the thread
+    // needs more and freed with the record, since other threads may be scanning them.
+    struct SlotBlock {
+        explicit SlotBlock(size_t n) : slots(new std::atomic<void*>[n]), size(n)
+        {
+            for (size_t i = 0; i < n; ++i) {
+                slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        std::unique_ptr<std::atomic<void*>[]> slots;
+        const size_t size;
+        std::atomic<SlotBlock*> next{nullptr};
+    };
+
     struct HPRecType {
         std::atomic_flag active = ATOMIC_FLAG_INIT;
         std::atomic<int> ref_count{0};
-        std::unique_ptr<void*[]> nodes;
-        const int num_of_nodes = 0;
         HPRecType* next = nullptr;
-        std::list<NodeToRetire> retire_list;
+        SlotBlock first_block;
+        // The number of slots while a thread owns the record, or 0.
+        std::atomic<size_t> num_live_slots{0};
+        std::atomic<bool> is_orphaned{false};  // set when the manager is destroyed
+
+        // Only accessed by the thread owning the record.
+        SlotBlock* last_block;
+        size_t num_slots;
+        std::vector<std::atomic<void*>*> free_slots;
+        size_t scan_threshold = 0;  // scans when retire_list reaches it
+        std::vector<NodeToRetire> retire_list;
+        // Nodes in retire_list not counted in the stats of the manager yet.
+        size_t num_uncounted = 0;
+        size_t uncounted_bytes = 0;
+        // The hazard pointers collected by Scan(), kept to reuse the memory.
+        std::vector<void*> hp_snapshot;
+
+        explicit HPRecType(size_t n) : ref_count(1), first_block(n), last_block(&first_block), num_slots(n)
+        {
+            free_slots.reserve(n);
+            for (size_t i = n; i > 0; --i) {
+                free_slots.push_back(&first_block.slots[i - 1]);
+            }
+        }
+
+        ~HPRecType()
+        {
+            for (auto& n : retire_list) {
+                n.deleter(n.node);
+            }
+            for (auto* b = first_block.next.load(std::memory_order_relaxed); b;) {
+                auto* next = b->next.load(std::memory_order_relaxed);
+                delete b;
+                b = next;
+            }
+        }
+
+        // Throws std::bad_alloc if memory is not available.
+        std::atomic<void*>* AcquireSlot();
+
+        void ReleaseSlot(std::atomic<void*>* slot)
+        {
+            slot->store(nullptr, std::memory_order_release);
+            // Never reallocates, since the capacity is the number of slots.
+            free_slots.push_back(slot);
+        }
 
-        HPRecType(int max_hp) : ref_count(1), nodes(new void*[max_hp]), num_of_nodes(max_hp)
+        template <typename F>
+        void ForEachSlot(F f) const
         {
-            for (int i = 0; i < max_hp; ++i) {
-                nodes[i] = nullptr;
+            for (auto* b = &first_block; b; b = b->next.load(std::memory_order_acquire)) {
+                for (size_t i = 0; i < b->size; ++i) {
+                    f(b->slots[i]);
+                }
             }
         }
 
@@ -106,7 +175,7 @@ private:
 
         void DecRef()
         {
-            int old = ref_count.fetch_sub(1, std::memory_order_relaxed);
+            int old = ref_count.fetch_sub(1, std::memory_order_acq_rel);
             assert(old >= 1);
             if (old <= 1) {
                 delete this;
@@ -116,34 +185,133 @@ private:
 
     HPRecType* AllocateHpRec();
 
+    // The records of the current thread, one per manager it uses.
+    struct ThreadRecords;
+
+    struct CachedRecord {
+        uint64_t manager_id;
+        HPRecType* record;
+    };
+
     HPRecType* GetHpRecForCurrentThread();
 
+    HPRecType* GetHpRecSlow();
+
     static void RetireHpRec(HPRecType* p);
 
-    void Scan();
+    void Scan(HPRecType* hp_rec);
+
+    void HelpScan(HPRecType* hp_rec);
+
+    size_t CountLiveSlots() const;
+
+    void RunReclaimer();
 
-    void HelpScan();
+    static std::atomic<uint64_t> s_next_id;
+    // The record the current thread used last, checked before s_thread_records.
+    static thread_local CachedRecord s_cached_record;
+    static thread_local ThreadRecords s_thread_records;
 
-    const int m_max_hp;
+    const uint64_t m_id;  // unique, unlike addresses of managers
+    const size_t m_initial_slots;
+    const size_t m_max_unreclaimed_bytes;
     std::atomic<HPRecType*> m_head{nullptr};
-    std::atomic<int> m_len{0};
-    boost::thread_specific_ptr<HPRecType> m_my_hp_rec{&HazardManager::RetireHpRec};
+
+    std::atomic<size_t> m_num_unreclaimed{0};
+    std::atomic<size_t> m_unreclaimed_bytes{0};
+
+    const std::chrono::milliseconds m_background_reclaim_interval;
+    std::mutex m_reclaimer_mutex;
+    std::condition_variable m_reclaimer_cond;  // notified on quit
+    bool m_should_quit = false;
+    std::thread m_reclaimer;
 
     friend class HazardPointer;
+    template <size_t N>
+    friend class HazardPointerArray;
 };
 
+// Owns a hazard pointer of the current thread.
 class HazardPointer final {
 public:
-    HazardPointer(HazardManager& mgr, int i = 0);
+    // Throws std::bad_alloc if the thread needs more hazard pointers and memory is not
+    // available.
+    explicit HazardPointer(HazardManager& mgr);
+
+    HazardPointer(const HazardPointer&) = delete;
+    void operator=(const HazardPointer&) = delete;
 
     ~HazardPointer();
 
+    // Loads `src' and protects the node it points to, retrying until `src' is
+    // unchanged after the hazard pointer is published. The node is safe to access
+    // until the hazard pointer is released or reused, if it is retired only after
+    // being unlinked from `src'.
+    template <typename T>
+    T* Protect(const std::atomic<T*>& src)
+    {
+        T* p = src.load(std::memory_order_relaxed);
+        while (true) {
+            m_hp->store(p, std::memory_order_relaxed);
+            // Pairs with the heavy fence of HazardManager::Scan().
+            AsymmetricLightFence();
+            T* q = src.load(std::memory_order_acquire);
+            if (q == p) {
+                return p;
+            }
+            p = q;
+        }
+    }
+
+    // Publishes `p'. The caller should check that `p' is still reachable afterwards,
+    // as Protect() does.
     void Acquire(void* p);
 
     void Release();
 
 private:
-    void** m_hp = nullptr;
+    template <size_t N>
+    friend class HazardPointerArray;
+
+    HazardPointer() = default;
+
+    void Init(HazardManager& mgr);
+
+    HazardManager::HPRecType* m_hp_rec = nullptr;
+    std::atomic<void*>* m_hp = nullptr;
+};
+
+// Owns N hazard pointers of the current thread, e.g. for traversals that protect the
+// previous and the current nodes.
+template <size_t N>
+class HazardPointerArray final {
+public:
+    // Throws std::bad_alloc if the thread needs more hazard pointers and memory is not
+    // available.
+    explicit HazardPointerArray(HazardManager& mgr)
+    {
+        static_assert(N > 0, "empty hazard pointer array");
+        for (auto& hp : m_hps) {
+            hp.Init(mgr);
+        }
+    }
+
+    HazardPointerArray(const HazardPointerArray&) = delete;
+    void operator=(const HazardPointerArray&) = delete;
+
+    HazardPointer& operator[](size_t i)
+    {
+        assert(i < N);
+        return m_hps[i];
+    }
+
+    static constexpr size_t size()
+    {
+        return N;
+    }
+
+private:
+    HazardPointer m_hps[N];
 };
 
 }  // namespace wsd
@@ -307,6 +307,8 @@ private:
 
     Future<V> load(const K& key, int64_t now);
 
+    Future<V> withDeadline(const Future<V>& value) const;
+
     void remove(typename M::iterator it);
 
     void evictEntries();
@@ -434,7 +436,7 @@ void LoadingCache<K, V>::scheduleRefresh(int64_t now, typename M::iterator it)
             newVal = m_loader(it->first);
         else
             return;
-        obj.refresh(newVal, now);
+        obj.refresh(withDeadline(newVal), now);
     }
 }
 
@@ -444,7 +446,7 @@ Future<V> LoadingCache<K, V>::load(const K& key, int64_t now)
     if (!m_loader) return Future<V>();
 
     Object obj;
-    obj.newVal = m_loader(key);
+    obj.newVal = withDeadline(m_loader(key));
     obj.writeTime = now;
     std::pair<typename M::iterator, bool> pair = m_map.insert(std::make_pair(key, obj));
     assert(pair.second);
@@ -453,6 +455,15 @@ Future<V> LoadingCache<K, V>::load(const K& key, int64_t now)
     return obj.newVal;
 }
 
+// A value loaded later than the expiration time would be expired as soon as it is
+// loaded, so the load is abandoned and cancelled then.
+template <typename K, typename V>
+Future<V> LoadingCache<K, V>::withDeadline(const Future<V>& value) const
+{
+    if (m_expireMilliseconds <= 0 || !value) return value;
+    return value.within(m_expireMilliseconds);
+}
+
 template <typename K, typename V>
 void LoadingCache<K, V>::remove(typename M::iterator it)
 {
@@ -0,0 +1,309 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+// Lock-free stacks, e.g. for free lists shared by many threads.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+#include <utility>
+
+#include "wsd/detail/cache_line.h"
+#include "wsd/hazard_pointer.h"
+
+namespace wsd {
+
+namespace detail {
+
+// The stack of Treiber: a linked list whose top is swung with a CAS. Popped nodes are
+// reclaimed through a HazardManager, which also rules out the ABA problem: a node
+// protected by a popper can not be freed and pushed again as a new node.
+template <typename T>
+class TreiberStack final {
+public:
+    struct Node {
+        template <typename... Args>
+        explicit Node(Args&&... args) : value(std::forward<Args>(args)...)
+        {
+        }
+
+        T value;
+        Node* next = nullptr;  // not modified once the node is pushed
+    };
+
+    TreiberStack() : m_hazard_manager(1)
+    {
+    }
+
+    TreiberStack(const TreiberStack&) = delete;
+    void operator=(const TreiberStack&) = delete;
+
+    ~TreiberStack()
+    {
+        for (Node* p = m_top.load(std::memory_order_relaxed); p;) {
+            Node* q = p;
+            p = p->next;
+            delete q;
+        }
+    }
+
+    HazardManager& hazard_manager()
+    {
+        return m_hazard_manager;
+    }
+
+    // Returns false if the top changed meanwhile.
+    bool TryPushOnce(Node* node)
+    {
+        Node* top = m_top.load(std::memory_order_relaxed);
+        node->next = top;
+        return m_top.compare_exchange_strong(top, node, std::memory_order_release, std::memory_order_relaxed);
+    }
+
+    enum PopResult { kPopped, kEmpty, kContended };
+
+    // Moves the top value into `value' on success.
+    PopResult TryPopOnce(HazardPointer* hp, T* value)
+    {
+        Node* top = hp->Protect(m_top);
+        if (!top) {
+            return kEmpty;
+        }
+        if (!m_top.compare_exchange_strong(top, top->next, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return kContended;
+        }
+        *value = std::move(top->value);
+        hp->Release();
+        m_hazard_manager.RetireNode(top);
+        return kPopped;
+    }
+
+private:
+    HazardManager m_hazard_manager;
+    std::atomic<Node*> m_top{nullptr};
+};
+
+}  // namespace detail
+
+// The Treiber stack.
+template <typename T>
+class LockFreeStack final {
+public:
+    LockFreeStack() = default;
+
+    LockFreeStack(const LockFreeStack&) = delete;
+    void operator=(const LockFreeStack&) = delete;
+
+    // Throws std::bad_alloc if memory is not available, or whatever constructing T
+    // throws.
+    template <typename U>
+    void Push(U&& value)
+    {
+        Node* node = new Node(std::forward<U>(value));
+        while (!m_stack.TryPushOnce(node)) {
+        }
+    }
+
+    // Returns false if the stack is empty.
+    bool TryPop(T* value)
+    {
+        HazardPointer hp(m_stack.hazard_manager());
+        while (true) {
+            switch (m_stack.TryPopOnce(&hp, value)) {
+            case Stack::kPopped:
+                return true;
+            case Stack::kEmpty:
+                return false;
+            case Stack::kContended:
+                break;
+            }
+        }
+    }
+
+private:
+    typedef detail::TreiberStack<T> Stack;
+    typedef typename Stack::Node Node;
+
+    Stack m_stack;
+};
+
+// A Treiber stack backed off to an elimination array: a push and a pop which fail
+// on the top because of contention meet in a random slot of the array, where the
+// pusher hands its node to the popper without touching the top at all. Like two
+// increments combined in a CombiningTree, the two operations cancel out, so the more
+// threads contend, the more of them complete off the top.
+//
+// Each slot is an exchanger on its own cache line, whose state says if it is empty,
+// holds the offer of a waiting thread, or holds the answer to that offer:
+//
+//   EMPTY --(offer)--> WAITING --(answer)--> BUSY --(offerer takes it)--> EMPTY
+//
+// An offerer which times out withdraws its offer. Pushers only accept pops, and
+// poppers only pushes; other exchanges are ignored and both sides retry.
+template <typename T>
+class EliminationBackoffStack final {
+public:
+    static constexpr int kDefaultSpins = 256;
+
+    // `width' is the number of exchangers, e.g. half of the threads expected to
+    // contend. A thread waits for a partner up to `spins' iterations.
+    explicit EliminationBackoffStack(int width = 4, int spins = kDefaultSpins)
+        : m_width(width > 0 ? width : 1),
+          m_spins(spins > 0 ? spins : 1),
+          m_exchangers(new Exchanger[m_width])
+    {
+    }
+
+    EliminationBackoffStack(const EliminationBackoffStack&) = delete;
+    void operator=(const EliminationBackoffStack&) = delete;
+
+    // Throws std::bad_alloc if memory is not available, or whatever constructing T
+    // throws.
+    template <typename U>
+    void Push(U&& value)
+    {
+        Node* node = new Node(std::forward<U>(value));
+        while (!m_stack.TryPushOnce(node)) {
+            // Pushers offer their nodes, and poppers null.
+            if (Exchange(node, true) == nullptr) {
+                return;
+            }
+        }
+    }
+
+    // Returns false if the stack is empty.
+    bool TryPop(T* value)
+    {
+        HazardPointer hp(m_stack.hazard_manager());
+        while (true) {
+            switch (m_stack.TryPopOnce(&hp, value)) {
+            case Stack::kPopped:
+                return true;
+            case Stack::kEmpty:
+                return false;
+            case Stack::kContended:
+                break;
+            }
+            Node* node = Exchange(nullptr, false);
+            if (node && node != kNoPartner) {
+                // The node was never shared with other poppers.
+                *value = std::move(node->value);
+                delete node;
+                return true;
+            }
+        }
+    }
+
+    // The operations eliminated, for tuning the width and spins.
+    uint64_t num_eliminated() const
+    {
+        return m_num_eliminated.load(std::memory_order_relaxed);
+    }
+
+private:
+    typedef detail::TreiberStack<T> Stack;
+    typedef typename Stack::Node Node;
+
+    enum State : uintptr_t { kEmptyState = 0, kWaiting = 1, kBusy = 2, kStateMask = 3 };
+
+    struct Exchanger {
+        // The offered node, or null for pops, tagged with the state.
+        std::atomic<uintptr_t> slot{kEmptyState};
+        char pad[detail::kCacheLineSize - sizeof(std::atomic<uintptr_t>)];
+    };
+
+    static Node* const kNoPartner;
+
+    // Offers `mine' in a random exchanger. Returns the node of a matching partner,
+    // which is null for a pop, or kNoPartner.
+    Node* Exchange(Node* mine, bool is_push)
+    {
+        Node* other = TryExchange(&m_exchangers[NextRandom() % m_width], mine);
+        if (other == kNoPartner || (other != nullptr) == is_push) {
+            // No partner, or the partner did the same operation.
+            return kNoPartner;
+        }
+        if (is_push) {
+            m_num_eliminated.fetch_add(2, std::memory_order_relaxed);
+        }
+        return other;
+    }
+
+    Node* TryExchange(Exchanger* exchanger, Node* mine)
+    {
+        uintptr_t offer = reinterpret_cast<uintptr_t>(mine);
+        for (int i = 0; i < m_spins; ++i) {
+            uintptr_t cur = exchanger->slot.load(std::memory_order_acquire);
+            switch (cur & kStateMask) {
+            case kEmptyState:
+                if (exchanger->slot.compare_exchange_strong(cur, offer | kWaiting, std::memory_order_acq_rel,
+                                                            std::memory_order_relaxed)) {
+                    return AwaitAnswer(exchanger, offer, m_spins - i);
+                }
+                break;
+            case kWaiting:
+                if (exchanger->slot.compare_exchange_strong(cur, offer | kBusy, std::memory_order_acq_rel,
+                                                            std::memory_order_relaxed)) {
+                    return reinterpret_cast<Node*>(cur & ~kStateMask);
+                }
+                break;
+            default:
+                // Two others are exchanging.
+                break;
+            }
+        }
+        return kNoPartner;
+    }
+
+    Node* AwaitAnswer(Exchanger* exchanger, uintptr_t offer, int spins)
+    {
+        for (int i = 0; i < spins; ++i) {
+            uintptr_t cur = exchanger->slot.load(std::memory_order_acquire);
+            if ((cur & kStateMask) == kBusy) {
+                exchanger->slot.store(kEmptyState, std::memory_order_release);
+                return reinterpret_cast<Node*>(cur & ~kStateMask);
+            }
+            if (i % 64 == 63) {
+                // Lets a partner sharing the CPU run.
+                std::this_thread::yield();
+            }
+        }
+        uintptr_t expected = offer | kWaiting;
+        if (exchanger->slot.compare_exchange_strong(expected, kEmptyState, std::memory_order_acquire)) {
+            return kNoPartner;
+        }
+        // Answered just before the withdrawal.
+        exchanger->slot.store(kEmptyState, std::memory_order_release);
+        return reinterpret_cast<Node*>(expected & ~kStateMask);
+    }
+
+    static uint32_t NextRandom()
+    {
+        static thread_local std::minstd_rand s_random(
+                static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+        return static_cast<uint32_t>(s_random());
+    }
+
+    Stack m_stack;
+    const int m_width;
+    const int m_spins;
+    std::unique_ptr<Exchanger[]> m_exchangers;
+    std::atomic<uint64_t> m_num_eliminated{0};
+};
+
+template <typename T>
+constexpr int EliminationBackoffStack<T>::kDefaultSpins;
+
+template <typename T>
+typename EliminationBackoffStack<T>::Node* const EliminationBackoffStack<T>::kNoPartner =
+        reinterpret_cast<typename EliminationBackoffStack<T>::Node*>(kStateMask + 1);
+
+}  // namespace wsd
@@ -0,0 +1,196 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+// A bounded multi-producer multi-consumer queue.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "wsd/detail/cache_line.h"
+#include "wsd/detail/waiters.h"
+
+namespace wsd {
+
+// A ring buffer of cells with sequence numbers, after Dmitry Vyukov's queue. The
+// sequence number of a cell tells the position it is ready for:
+//
+//   - pos: empty, a producer claiming position pos may fill it;
+//   - pos + 1: full, a consumer claiming position pos may empty it;
+//   - otherwise the cell is still used for an earlier lap.
+//
+// Producers and consumers claim positions with a CAS on their own counter, and only
+// touch the cells they claimed, so they contend with each other only when the queue
+// is nearly empty or full.
+template <typename T>
+class BoundedMpmcQueue final {
+public:
+    static_assert(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+                  "elements should be nothrow movable");
+
+    // The capacity is rounded up to a power of two, and is at least 2.
+    explicit BoundedMpmcQueue(size_t capacity) : m_mask(RoundUpToPowerOfTwo(capacity) - 1)
+    {
+        m_cells.reset(new Cell[m_mask + 1]);
+        for (size_t i = 0; i <= m_mask; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+    void operator=(const BoundedMpmcQueue&) = delete;
+
+    ~BoundedMpmcQueue()
+    {
+        size_t end = m_enqueue_pos.load(std::memory_order_relaxed);
+        for (size_t pos = m_dequeue_pos.load(std::memory_order_relaxed); pos != end; ++pos) {
+            ValueOf(m_cells[pos & m_mask])->~T();
+        }
+    }
+
+    size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+    // Returns false if the queue is full. `value' is moved from only on success.
+    bool TryPush(T&& value)
+    {
+        Cell* cell = ClaimForPush();
+        if (!cell) {
+            return false;
+        }
+        new (&cell->storage) T(std::move(value));
+        cell->sequence.fetch_add(1, std::memory_order_release);
+        m_not_empty.Notify();
+        return true;
+    }
+
+    // Throws whatever copying `value' throws.
+    bool TryPush(const T& value)
+    {
+        T copy(value);
+        return TryPush(std::move(copy));
+    }
+
+    // Returns false if the queue is empty.
+    bool TryPop(T* value)
+    {
+        size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        T* p = ValueOf(*cell);
+        *value = std::move(*p);
+        p->~T();
+        // Ready for the producer of the next lap.
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_not_full.Notify();
+        return true;
+    }
+
+    // Blocks while the queue is full.
+    void Push(T&& value)
+    {
+        while (!TryPush(std::move(value))) {
+            m_not_full.Wait([this]() { return IsReady(m_enqueue_pos, 0); });
+        }
+    }
+
+    // Throws whatever copying `value' throws.
+    void Push(const T& value)
+    {
+        T copy(value);
+        Push(std::move(copy));
+    }
+
+    // Blocks while the queue is empty.
+    void Pop(T* value)
+    {
+        while (!TryPop(value)) {
+            m_not_empty.Wait([this]() { return IsReady(m_dequeue_pos, 1); });
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    static size_t RoundUpToPowerOfTwo(size_t n)
+    {
+        size_t size = 2;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    static T* ValueOf(Cell& cell)
+    {
+        return reinterpret_cast<T*>(&cell.storage);
+    }
+
+    // Returns true if the cell at position `pos' is ready, i.e. its sequence number is
+    // pos + offset, or if `pos' is stale.
+    bool IsReady(const std::atomic<size_t>& pos, size_t offset) const
+    {
+        size_t p = pos.load(std::memory_order_relaxed);
+        size_t seq = m_cells[p & m_mask].sequence.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(seq) - static_cast<intptr_t>(p + offset) >= 0;
+    }
+
+    // Returns the empty cell claimed, or null if the queue is full.
+    Cell* ClaimForPush()
+    {
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell* cell = &m_cells[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    return cell;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    // Producers and consumers write their counters on separate cache lines.
+    char m_pad0[detail::kCacheLineSize];
+    std::atomic<size_t> m_enqueue_pos{0};
+    char m_pad1[detail::kCacheLineSize];
+    std::atomic<size_t> m_dequeue_pos{0};
+    char m_pad2[detail::kCacheLineSize];
+    detail::Waiters m_not_full;
+    detail::Waiters m_not_empty;
+};
+
+}  // namespace wsd
@@ -0,0 +1,168 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+// An unbounded multi-producer multi-consumer queue.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "wsd/detail/cache_line.h"
+#include "wsd/detail/waiters.h"
+#include "wsd/hazard_pointer.h"
+
+namespace wsd {
+
+// The lock-free queue of Michael and Scott. The queue is a linked list starting with
+// a dummy node, whose successor holds the first element:
+//
+//   - Push() links a node after the last one with a CAS, then swings the tail to it.
+//     Either step may be done by another thread which finds the tail lagging.
+//   - Pop() swings the head to its successor, which becomes the new dummy node after
+//     its value is moved out, and retires the old dummy node.
+//
+// Nodes are reclaimed through a HazardManager owned by the queue, so a thread stalled
+// in Push() or Pop() keeps at most two nodes from being freed.
+template <typename T>
+class MsQueue final {
+public:
+    static_assert(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+                  "elements should be nothrow movable");
+
+    // Throws std::bad_alloc if memory is not available.
+    MsQueue() : m_hazard_manager(2)
+    {
+        Node* dummy = new Node();
+        m_head.store(dummy, std::memory_order_relaxed);
+        m_tail.store(dummy, std::memory_order_relaxed);
+    }
+
+    MsQueue(const MsQueue&) = delete;
+    void operator=(const MsQueue&) = delete;
+
+    ~MsQueue()
+    {
+        Node* p = m_head.load(std::memory_order_relaxed);
+        Node* next = p->next.load(std::memory_order_relaxed);
+        delete p;
+        while (next) {
+            p = next;
+            next = p->next.load(std::memory_order_relaxed);
+            p->value()->~T();
+            delete p;
+        }
+    }
+
+    // Never blocks. Throws std::bad_alloc if memory is not available, in which case
+    // `value' is not moved from.
+    void Push(T&& value)
+    {
+        HazardPointer hp(m_hazard_manager);
+        Node* node = new Node();
+        new (&node->storage) T(std::move(value));
+        Link(&hp, node);
+        m_not_empty.Notify();
+    }
+
+    // Throws whatever copying `value' throws too.
+    void Push(const T& value)
+    {
+        T copy(value);
+        Push(std::move(copy));
+    }
+
+    // Returns false if the queue is empty.
+    bool TryPop(T* value)
+    {
+        HazardPointerArray<2> hps(m_hazard_manager);
+        while (true) {
+            Node* head = hps[0].Protect(m_head);
+            Node* tail = m_tail.load(std::memory_order_acquire);
+            Node* next = hps[1].Protect(head->next);
+            if (head != m_head.load(std::memory_order_acquire)) {
+                // `next' may have been retired before being protected.
+                continue;
+            }
+            if (!next) {
+                return false;
+            }
+            if (head == tail) {
+                // Helps the pusher which has not swung the tail yet.
+                m_tail.compare_exchange_strong(tail, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+            if (m_head.compare_exchange_strong(head, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                // Only the thread swinging the head touches the value, and `next' is kept
+                // alive by the hazard pointer until the value is moved out.
+                T* p = next->value();
+                *value = std::move(*p);
+                p->~T();
+                hps[0].Release();
+                hps[1].Release();
+                m_hazard_manager.RetireNode(head);
+                return true;
+            }
+        }
+    }
+
+    // Blocks while the queue is empty.
+    void Pop(T* value)
+    {
+        while (!TryPop(value)) {
+            m_not_empty.Wait([this]() { return !IsEmpty(); });
+        }
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T* value()
+        {
+            return reinterpret_cast<T*>(&storage);
+        }
+    };
+
+    void Link(HazardPointer* hp, Node* node)
+    {
+        while (true) {
+            Node* tail = hp->Protect(m_tail);
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (next) {
+                // The tail lags, swing it before retrying.
+                m_tail.compare_exchange_strong(tail, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+            if (tail->next.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed)) {
+                m_tail.compare_exchange_strong(tail, node, std::memory_order_release, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    bool IsEmpty()
+    {
+        HazardPointer hp(m_hazard_manager);
+        Node* head = hp.Protect(m_head);
+        return head->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+    // Frees the retired nodes when destroyed.
+    HazardManager m_hazard_manager;
+    // Pushers and poppers write to separate cache lines.
+    char m_pad0[detail::kCacheLineSize];
+    std::atomic<Node*> m_head{nullptr};
+    char m_pad1[detail::kCacheLineSize];
+    std::atomic<Node*> m_tail{nullptr};
+    char m_pad2[detail::kCacheLineSize];
+    detail::Waiters m_not_empty;
+};
+
+}  // namespace wsd
@@ -0,0 +1,261 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#ifndef __ONCE_CALLBACK_H__
+#define __ONCE_CALLBACK_H__
+
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "bind_detail.h"
+#include "callback.h"
+#include "callback_detail.h"
+#include "wsd_magic.h"
+
+// OnceCallback is a move-only Callback which can be run at most once. Running it
+// consumes the callback and moves the bound arguments into the target, so that:
+//
+//   - bound arguments are never copied, neither on construction nor when run;
+//   - bound arguments can be move-only, e.g. std::unique_ptr or buffers.
+//
+// OnceCallbacks are created by bindOnce(), which takes the same functors and argument
+// wrappers (owned(), unretained(), shared()) as bind(). Arguments passed as rvalues
+// are moved into the callback.
+//
+//   void consume(std::unique_ptr<Buffer> buffer, int n) { ... }
+//
+//   std::unique_ptr<Buffer> buffer(new Buffer());
+//   wsd::OnceCallback<void(int)> cb = wsd::bindOnce(&consume, std::move(buffer));
+//   std::move(cb)(3);  // cb is null afterwards
+//
+// Unbound arguments are perfectly forwarded to the target too.
+//
+// Small bound states are stored inline as with Callback (see CallbackStorage), which
+// only requires them to be nothrow-movable.
+
+namespace wsd {
+
+template <typename Signature>
+class OnceCallback;
+
+namespace detail {
+
+// OnceFunctorTraits<> calls functions, class methods and callbacks with forwarded
+// arguments.
+template <typename Functor>
+struct OnceFunctorTraits;
+
+template <typename R, typename... As>
+struct OnceFunctorTraits<R (*)(As...)> {
+    typedef R(RunType)(As...);
+
+    template <typename... Ts>
+    static R invoke(R (*pf)(As...), Ts&&... args)
+    {
+        return (*pf)(std::forward<Ts>(args)...);
+    }
+};
+
+template <typename R, typename T, typename... As>
+struct OnceFunctorTraits<R (T::*)(As...)> {
+    typedef R(RunType)(T*, As...);
+
+    template <typename... Ts>
+    static R invoke(R (T::*pmf)(As...), T* pobj, Ts&&... args)
+    {
+        return (pobj->*pmf)(std::forward<Ts>(args)...);
+    }
+};
+
+template <typename R, typename T, typename... As>
+struct OnceFunctorTraits<R (T::*)(As...) const> {
+    typedef R(RunType)(const T*, As...);
+
+    template <typename... Ts>
+    static R invoke(R (T::*pmf)(As...) const, const T* pobj, Ts&&... args)
+    {
+        return (pobj->*pmf)(std::forward<Ts>(args)...);
+    }
+};
+
+template <typename R, typename... As>
+struct OnceFunctorTraits<Callback<R(As...)>> {
+    typedef R(RunType)(As...);
+
+    template <typename... Ts>
+    static R invoke(const Callback<R(As...)>& callback, Ts&&... args)
+    {
+        return callback(std::forward<Ts>(args)...);
+    }
+};
+
+template <typename R, typename... As>
+struct OnceFunctorTraits<OnceCallback<R(As...)>> {
+    typedef R(RunType)(As...);
+
+    template <typename... Ts>
+    static R invoke(OnceCallback<R(As...)>& callback, Ts&&... args)
+    {
+        return std::move(callback)(std::forward<Ts>(args)...);
+    }
+};
+
+// Moves the stored bound arguments out, and unwraps the argument wrappers.
+template <typename T>
+struct OnceUnwrapTraits {
+    static T&& unwrap(T& o)
+    {
+        return std::move(o);
+    }
+};
+
+template <typename T>
+struct OnceUnwrapTraits<UnretainedWrapper<T>> {
+    static T* unwrap(const UnretainedWrapper<T>& unretained)
+    {
+        return unretained.get();
+    }
+};
+
+template <typename T>
+struct OnceUnwrapTraits<OwnedWrapper<T>> {
+    static T* unwrap(const OwnedWrapper<T>& owned)
+    {
+        return owned.get();
+    }
+};
+
+template <typename T>
+struct OnceUnwrapTraits<SharedWrapper<T>> {
+    static T* unwrap(const SharedWrapper<T>& shared)
+    {
+        return shared.get();
+    }
+};
+
+template <typename Functor, typename... BoundArgs>
+class OnceBindState : public BindStateBase {
+public:
+    typedef OnceFunctorTraits<Functor> Traits;
+    typedef typename DropParams<sizeof...(BoundArgs), typename Traits::RunType>::type UnboundRunType;
+
+    template <typename... Args>
+    explicit OnceBindState(const Functor& functor, Args&&... args)
+        : m_functor(functor), m_bound_args(std::forward<Args>(args)...)
+    {
+    }
+
+    template <typename R, typename... UnboundArgs>
+    static R invoke(BindStateBase* base, UnboundArgs&&... args)
+    {
+        OnceBindState* bind_state = static_cast<OnceBindState*>(base);
+        return bind_state->template run<R>(typename MakeIndexSequence<sizeof...(BoundArgs)>::type(),
+                                           std::forward<UnboundArgs>(args)...);
+    }
+
+private:
+    template <typename R, size_t... Is, typename... UnboundArgs>
+    R run(IndexSequence<Is...>, UnboundArgs&&... args)
+    {
+        return Traits::invoke(m_functor,
+                              OnceUnwrapTraits<BoundArgs>::unwrap(std::get<Is>(m_bound_args))...,
+                              std::forward<UnboundArgs>(args)...);
+    }
+
+    Functor m_functor;
+    std::tuple<BoundArgs...> m_bound_args;
+};
+
+}  // namespace detail
+
+template <typename R, typename... Args>
+class OnceCallback<R(Args...)> {
+private:
+    typedef R (*PolymorphicInvoke)(detail::BindStateBase*, Args&&...);
+
+public:
+    typedef R(RunType)(Args...);
+    typedef PolymorphicInvoke unspecified_bool_type;
+
+    OnceCallback()
+    {
+    }
+
+    OnceCallback(OnceCallback&& other) : m_storage(std::move(other.m_storage))
+    {
+    }
+
+    OnceCallback& operator=(OnceCallback&& other)
+    {
+        m_storage = std::move(other.m_storage);
+        return *this;
+    }
+
+    // A Callback can be run once too. Implicit so that both can be passed where a
+    // OnceCallback is expected.
+    OnceCallback(const Callback<R(Args...)>& callback)
+    {
+        if (callback) *this = OnceCallback(detail::OnceBindState<Callback<R(Args...)>>(callback));
+    }
+
+    // Should be private, but avoids template friendship issues.
+    template <typename Functor, typename... BoundArgs>
+    explicit OnceCallback(detail::OnceBindState<Functor, BoundArgs...>&& bind_state)
+        : m_storage(detail::CallbackStorage::MoveOnly(),
+                    std::move(bind_state),
+                    reinterpret_cast<detail::CallbackStorage::InvokeFuncStorage>(
+                            &detail::OnceBindState<Functor, BoundArgs...>::template invoke<R, Args...>))
+    {
+    }
+
+    /**
+     * Runs the callback, moving the bound arguments into the target. The callback is
+     * null afterwards, and the bound state is destroyed before this returns.
+     */
+    R operator()(Args... args) &&
+    {
+        detail::CallbackStorage storage(std::move(m_storage));
+        return storage.invoker<PolymorphicInvoke>()(storage.get(), std::forward<Args>(args)...);
+    }
+
+    operator unspecified_bool_type() const
+    {
+        return m_storage.invoker<PolymorphicInvoke>();
+    }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(OnceCallback);
+
+    detail::CallbackStorage m_storage;
+};
+
+/**
+ * Binds `args' to `functor' like bind(), but returns a OnceCallback. Arguments passed
+ * as rvalues are moved into the callback, and may be move-only.
+ *
+ * \throws std::bad_alloc if the bound state is not stored inline and memory is not
+ *         available, or whatever copying or moving the arguments throws.
+ */
+template <typename Functor, typename... Args>
+OnceCallback<typename detail::OnceBindState<Functor, typename std::decay<Args>::type...>::UnboundRunType>
+bindOnce(Functor functor, Args&&... args)
+{
+    typedef detail::OnceBindState<Functor, typename std::decay<Args>::type...> BindState;
+    typedef typename detail::OnceFunctorTraits<Functor>::RunType RunType;
+
+    // See bind() for the reasons.
+    static_assert(!detail::HasBoundNonConstRef<sizeof...(Args), RunType>::value, "do not bind non-const reference");
+    static_assert(!detail::AnyPointer<typename std::decay<Args>::type...>::value,
+                  "do_not_pass_raw_pointers_as_bound_argument");
+
+    return OnceCallback<typename BindState::UnboundRunType>(BindState(functor, std::forward<Args>(args)...));
+}
+
+}  // namespace wsd
+
+#endif  // __ONCE_CALLBACK_H__
@@ -7,15 +7,20 @@
 #ifndef __PROMISE_H__
 #define __PROMISE_H__
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <exception>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <type_traits>
 
 #include "bind.h"
 #include "callback.h"
+#include "detail/timer_queue.h"
 #include "wsd_magic.h"
 
 namespace wsd {
@@ -26,6 +31,15 @@ class PromiseAlreadySatisfiedException : public std::exception {
 class FutureUninitialized : public std::exception {
 };
 
+// Raised to the producer of a future by Future::cancel().
+class FutureCancelledException : public std::exception {
+};
+
+// Raised to the producer of a future, and set to the future returned by
+// Future::within(), when the deadline is exceeded.
+class FutureTimeoutException : public std::exception {
+};
+
 template <typename T>
 class Future;
 
@@ -41,6 +55,23 @@ class Promise;
 
 namespace detail {
 
+typedef std::chrono::steady_clock::time_point TimePoint;
+
+// Deadlines of other clocks are converted to the steady clock, so that waiting is
+// not affected by adjustments of the system clock.
+template <typename Clock, typename Duration>
+TimePoint toSteadyTimePoint(const std::chrono::time_point<Clock, Duration>& deadline)
+{
+    return std::chrono::steady_clock::now()
+           + std::chrono::duration_cast<std::chrono::steady_clock::duration>(deadline - Clock::now());
+}
+
+template <typename Duration>
+TimePoint toSteadyTimePoint(const std::chrono::time_point<std::chrono::steady_clock, Duration>& deadline)
+{
+    return std::chrono::time_point_cast<std::chrono::steady_clock::duration>(deadline);
+}
+
 template <typename T>
 struct resolved_type {
     typedef T type;
@@ -106,8 +137,40 @@ struct FutureTraits<void> {
     typedef void move_dest_type;
 };
 
+// Interrupts are sent by consumers of a future to its producer to tell that the
+// result is no longer needed, e.g. because the request is cancelled or timed out. This
+// is the part of future objects that deals with interrupts, regardless of the value
+// type.
+class InterruptibleFutureObject {
+public:
+    typedef Callback<void(const std::exception_ptr&)> InterruptHandlerType;
+
+    virtual ~InterruptibleFutureObject()
+    {
+    }
+
+    // Prompt futures are always done, so they ignore interrupts.
+    virtual void raise(const std::exception_ptr& /*e*/)
+    {
+    }
+    virtual void setInterruptHandler(const InterruptHandlerType& /*handler*/)
+    {
+    }
+    virtual bool isInterrupted() const
+    {
+        return false;
+    }
+};
+
+// Forwards the interrupt to `future' if it is still alive.
+inline void forwardInterrupt(const std::weak_ptr<InterruptibleFutureObject>& future, const std::exception_ptr& e)
+{
+    std::shared_ptr<InterruptibleFutureObject> p = future.lock();
+    if (p) p->raise(e);
+}
+
 template <typename T>
-class FutureObjectInterface {
+class FutureObjectInterface : public InterruptibleFutureObject {
 public:
     typedef typename FutureTraits<T>::rvalue_source_type rvalue_source_type;
     typedef typename FutureTraits<T>::move_dest_type move_dest_type;
@@ -135,6 +198,8 @@ public:
 
     virtual move_dest_type get() const = 0;
     virtual bool tryGet(dest_reference_type v) const = 0;
+    // Returns true if done before `deadline'.
+    virtual bool waitUntil(const TimePoint& deadline) const = 0;
     virtual void registerCallback(const CallbackType& callback) = 0;
     virtual storage_type getStorageValue() const = 0;
     virtual void setValueFromStorage(const storage_type& /*v*/)
@@ -144,7 +209,7 @@ public:
 };
 
 template <>
-class FutureObjectInterface<void> {
+class FutureObjectInterface<void> : public InterruptibleFutureObject {
 public:
     typedef FutureTraits<void>::move_dest_type move_dest_type;
     typedef Callback<void(const std::shared_ptr<FutureObjectInterface>&)> CallbackType;
@@ -168,6 +233,8 @@ public:
     }
 
     virtual move_dest_type get() const = 0;
+    // Returns true if done before `deadline'.
+    virtual bool waitUntil(const TimePoint& deadline) const = 0;
     virtual void registerCallback(const CallbackType& callback) = 0;
 };
 
@@ -222,10 +289,16 @@ public:
 
     virtual bool tryGet(dest_reference_type v) const
     {
+        if (m_exception_ptr) std::rethrow_exception(m_exception_ptr);
         FutureTraits<T>::assign(v, m_value);
         return true;
     }
 
+    virtual bool waitUntil(const TimePoint& /*deadline*/) const
+    {
+        return true;
+    }
+
     virtual void registerCallback(const CallbackType& callback)
     {
         assert(callback);
@@ -238,6 +311,7 @@ public:
 
     virtual storage_type getStorageValue() const
     {
+        if (m_exception_ptr) std::rethrow_exception(m_exception_ptr);
         return m_value;
     }
 
@@ -297,6 +371,11 @@ public:
         if (m_exception_ptr) std::rethrow_exception(m_exception_ptr);
     }
 
+    virtual bool waitUntil(const TimePoint& /*deadline*/) const
+    {
+        return true;
+    }
+
     virtual void registerCallback(const CallbackType& callback)
     {
         assert(callback);
@@ -312,6 +391,8 @@ private:
 };
 
 struct FutureObjectBase {
+    typedef InterruptibleFutureObject::InterruptHandlerType InterruptHandlerType;
+
     FutureObjectBase() : m_is_done(false)
     {
     }
@@ -368,10 +449,82 @@ struct FutureObjectBase {
         if (m_exception_ptr) std::rethrow_exception(m_exception_ptr);
     }
 
+    bool waitUntilInternal(const TimePoint& deadline) const
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_is_done) {
+            if (m_cond.wait_until(lock, deadline) == std::cv_status::timeout) return m_is_done;
+        }
+        return true;
+    }
+
+    // Only the first interrupt is delivered, and interrupts to done futures are ignored.
+    void raiseInterrupt(const std::exception_ptr& e)
+    {
+        assert(e);
+        InterruptHandlerType handler;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_is_done || m_interrupt) return;
+            m_interrupt = e;
+            handler = m_interrupt_handler;
+        }
+
+        // Run the handler without locks because it usually satisfies this future.
+        if (handler) {
+            try {
+                handler(e);
+            } catch (...) {
+                // Ignore the exceptions thrown by the handler.
+            }
+        }
+    }
+
+    void setInterruptHandlerInternal(const InterruptHandlerType& handler)
+    {
+        std::exception_ptr interrupt;
+        InterruptHandlerType old_handler;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_is_done) return;
+            interrupt = m_interrupt;
+            // Destroy the old handler out of the lock.
+            old_handler = m_interrupt_handler;
+            m_interrupt_handler = handler;
+        }
+
+        // Interrupted before the handler is set.
+        if (interrupt && handler) {
+            try {
+                handler(interrupt);
+            } catch (...) {
+                // Ignore the exceptions thrown by the handler.
+            }
+        }
+    }
+
+    bool isInterruptedInternal() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_interrupt != nullptr;
+    }
+
+    // Release the interrupt handler once done, which may hold references to other
+    // futures. Must be called without locks.
+    void clearInterruptHandler()
+    {
+        InterruptHandlerType handler;  // destroyed after the lock is released
+        std::lock_guard<std::mutex> lock(m_mutex);
+        handler = m_interrupt_handler;
+        m_interrupt_handler = InterruptHandlerType();
+    }
+
     mutable std::mutex m_mutex;
     mutable std::condition_variable m_cond;  // predicate: m_is_done == true
     bool m_is_done;                          // either a value or exception is set
     std::exception_ptr m_exception_ptr;
+    std::exception_ptr m_interrupt;           // the first interrupt raised by consumers
+    InterruptHandlerType m_interrupt_handler;  // set by the producer
 };
 
 template <typename T>
@@ -384,6 +537,7 @@ public:
     typedef typename FutureObjectInterface<T>::storage_type storage_type;
     typedef typename FutureObjectInterface<T>::CallbackType CallbackType;
     typedef typename FutureObjectInterface<T>::dest_reference_type dest_reference_type;
+    typedef InterruptibleFutureObject::InterruptHandlerType InterruptHandlerType;
 
     FutureObject()
     {
@@ -398,6 +552,21 @@ public:
         return FutureObjectBase::isDone();
     }
 
+    virtual void raise(const std::exception_ptr& e)
+    {
+        raiseInterrupt(e);
+    }
+
+    virtual void setInterruptHandler(const InterruptHandlerType& handler)
+    {
+        setInterruptHandlerInternal(handler);
+    }
+
+    virtual bool isInterrupted() const
+    {
+        return isInterruptedInternal();
+    }
+
     virtual bool hasValue() const
     {
         return FutureObjectBase::hasValue();
@@ -416,6 +585,11 @@ public:
         return *m_value;
     }
 
+    virtual bool waitUntil(const TimePoint& deadline) const
+    {
+        return waitUntilInternal(deadline);
+    }
+
     virtual bool tryGet(dest_reference_type v) const
     {
         if (!isDone()) return false;
@@ -489,6 +663,8 @@ private:
     // happen because the callback passed by users may want to acquire the lock.
     void doPendingCallbacks()
     {
+        clearInterruptHandler();
+
         std::list<CallbackType> callbacks;
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -515,6 +691,7 @@ class FutureObject<void> : public FutureObjectInterface<void>,
                            private FutureObjectBase {
 public:
     using typename FutureObjectInterface<void>::CallbackType;
+    typedef InterruptibleFutureObject::InterruptHandlerType InterruptHandlerType;
 
     FutureObject()
     {
@@ -529,6 +706,21 @@ public:
         return FutureObjectBase::isDone();
     }
 
+    virtual void raise(const std::exception_ptr& e)
+    {
+        raiseInterrupt(e);
+    }
+
+    virtual void setInterruptHandler(const InterruptHandlerType& handler)
+    {
+        setInterruptHandlerInternal(handler);
+    }
+
+    virtual bool isInterrupted() const
+    {
+        return isInterruptedInternal();
+    }
+
     virtual bool hasValue() const
     {
         return FutureObjectBase::hasValue();
@@ -544,6 +736,11 @@ public:
         wait();
     }
 
+    virtual bool waitUntil(const TimePoint& deadline) const
+    {
+        return waitUntilInternal(deadline);
+    }
+
     virtual void set()
     {
         {
@@ -588,6 +785,8 @@ private:
     // happen because the callback passed by users may want to acquire the lock.
     void doPendingCallbacks()
     {
+        clearInterruptHandler();
+
         std::list<CallbackType> callbacks;
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -605,6 +804,8 @@ private:
 template <typename R>
 class ForwardValue;
 
+struct FutureAccess;
+
 // This class is used to wrap the callback passed by 'then()' so that its return
 // value can be captured and used to satisfy the promise that 'then()' returns'.
 template <typename R, typename T>
@@ -647,8 +848,12 @@ public:
     typename std::enable_if<is_future_type<U>::value>::type run(const FuturePtr& future)
     {
         try {
-            m_callback(future).then(wsd::bind(&ForwardValue<value_type>::template run<value_type>,
-                                              owned(new ForwardValue<value_type>(m_promise))));
+            U inner_future = m_callback(future);
+            // From now on the interrupts to the future returned by then() go to the inner future.
+            m_promise.setInterruptHandler(
+                    wsd::bind(&forwardInterrupt, std::weak_ptr<InterruptibleFutureObject>(inner_future.m_future)));
+            inner_future.then(wsd::bind(&ForwardValue<value_type>::template run<value_type>,
+                                        owned(new ForwardValue<value_type>(m_promise))));
         } catch (...) {
             m_promise.setException(std::current_exception());
         }
@@ -737,6 +942,56 @@ public:
         return m_future && m_future->hasException();
     }
 
+    /**
+     * Blocks until this future is satisfied or `timeout' elapses. Returns true if it is
+     * satisfied, either with a value or an exception.
+     *
+     * \throws FutureUninitialized if this future is not initialized.
+     */
+    template <typename Rep, typename Period>
+    bool waitFor(const std::chrono::duration<Rep, Period>& timeout) const
+    {
+        return waitUntil(std::chrono::steady_clock::now() + timeout);
+    }
+
+    /**
+     * Blocks until this future is satisfied or `deadline' is reached. Returns true if
+     * it is satisfied, either with a value or an exception.
+     *
+     * \throws FutureUninitialized if this future is not initialized.
+     */
+    template <typename Clock, typename Duration>
+    bool waitUntil(const std::chrono::time_point<Clock, Duration>& deadline) const
+    {
+        if (!m_future) throw FutureUninitialized();
+        return m_future->waitUntil(toSteadyTimePoint(deadline));
+    }
+
+    /**
+     * Tells the producer of this future that its result is no longer needed by raising
+     * FutureCancelledException to the interrupt handler set by the producer (see
+     * Promise::setInterruptHandler()). The interrupt is propagated upstream through the
+     * chain of then(). This future is not satisfied unless the producer does so in
+     * response.
+     *
+     * \throws std::bad_alloc, or FutureUninitialized if this future is not initialized.
+     */
+    void cancel() const
+    {
+        raise(std::make_exception_ptr(FutureCancelledException()));
+    }
+
+    /**
+     * Raises an arbitrary interrupt to the producer of this future. See cancel().
+     *
+     * \throws FutureUninitialized if this future is not initialized.
+     */
+    void raise(const std::exception_ptr& e) const
+    {
+        if (!m_future) throw FutureUninitialized();
+        m_future->raise(e);
+    }
+
     /**
      * Returns true if this future has been initialized.
      */
@@ -791,11 +1046,48 @@ public:
         if (!this->m_future) throw FutureUninitialized();
 
         Promise<value_type> promise;
+        promise.setInterruptHandler(wsd::bind(&detail::forwardInterrupt,
+                                              std::weak_ptr<detail::InterruptibleFutureObject>(this->m_future)));
         this->m_future->registerCallback(wsd::bind(&detail::SequentialCallback<R, T>::template run<R>,
                                                    owned(new detail::SequentialCallback<R, T>(callback, promise))));
         return promise.getFuture();
     }
 
+    /**
+     * Returns a future which is satisfied with the result of this future if it is
+     * satisfied within `milliseconds', or with FutureTimeoutException otherwise. In the
+     * latter case FutureTimeoutException is also raised to the producer of this future
+     * (see cancel()), so that the work can be abandoned. Interrupts to the returned
+     * future are forwarded to this future.
+     *
+     * \throws std::bad_alloc, or FutureUninitialized if this future is not initialized.
+     */
+    Future within(int64_t milliseconds) const;
+
+    /**
+     * Assigns the value to `v' and returns true if this future is satisfied, or returns
+     * false otherwise without blocking.
+     *
+     * \throws the exception this future is satisfied with, or FutureUninitialized.
+     */
+    bool tryGet(typename detail::FutureTraits<T>::dest_reference_type v) const
+    {
+        if (!this->m_future) throw FutureUninitialized();
+        return this->m_future->tryGet(v);
+    }
+
+    /**
+     * Like tryGet(v), but blocks for at most `timeout' until this future is satisfied.
+     *
+     * \throws the exception this future is satisfied with, or FutureUninitialized.
+     */
+    template <typename Rep, typename Period>
+    bool tryGet(typename detail::FutureTraits<T>::dest_reference_type v,
+                const std::chrono::duration<Rep, Period>& timeout) const
+    {
+        return this->waitFor(timeout) && tryGet(v);
+    }
+
 private:
     Future(const typename detail::FutureBase<T>::FuturePtr& future) : detail::FutureBase<T>(future)
     {
@@ -805,6 +1097,7 @@ private:
     friend class detail::SequentialCallback;
     template <typename R>
     friend class detail::ForwardValue;
+    friend struct detail::FutureAccess;
     friend class Promise<T>;
 };
 
@@ -837,11 +1130,24 @@ public:
         if (!this->m_future) throw FutureUninitialized();
 
         Promise<value_type> promise;
+        promise.setInterruptHandler(wsd::bind(&detail::forwardInterrupt,
+                                              std::weak_ptr<detail::InterruptibleFutureObject>(this->m_future)));
         this->m_future->registerCallback(wsd::bind(&detail::SequentialCallback<R, void>::template run<R>,
                                                    owned(new detail::SequentialCallback<R, void>(callback, promise))));
         return promise.getFuture();
     }
 
+    /**
+     * Returns a future which is satisfied with the result of this future if it is
+     * satisfied within `milliseconds', or with FutureTimeoutException otherwise. In the
+     * latter case FutureTimeoutException is also raised to the producer of this future
+     * (see cancel()), so that the work can be abandoned. Interrupts to the returned
+     * future are forwarded to this future.
+     *
+     * \throws std::bad_alloc, or FutureUninitialized if this future is not initialized.
+     */
+    Future within(int64_t milliseconds) const;
+
 private:
     Future(const detail::FutureBase<void>::FuturePtr& future) : detail::FutureBase<void>(future)
     {
@@ -854,6 +1160,7 @@ private:
 
     template <typename R, typename U>
     friend class detail::SequentialCallback;
+    friend struct detail::FutureAccess;
     friend class Promise<void>;
 };
 
@@ -907,6 +1214,31 @@ public:
         return Future<T>(m_future);
     }
 
+    /**
+     * Sets the handler to run when a consumer interrupts the future, e.g. by
+     * Future::cancel() or the deadline of Future::within(). It is usually used to stop
+     * the work and satisfy the future with the interrupt. If the future has already been
+     * interrupted the handler is run immediately. A new handler replaces the old one,
+     * and handlers are dropped once the future is satisfied.
+     *
+     * \throws nothing
+     */
+    void setInterruptHandler(const Callback<void(const std::exception_ptr&)>& handler)
+    {
+        m_future->setInterruptHandler(handler);
+    }
+
+    /**
+     * Returns true if a consumer has interrupted the future. It can be polled by
+     * long-running producers as a cancellation token.
+     *
+     * \throws nothing
+     */
+    bool isInterrupted() const
+    {
+        return m_future->isInterrupted();
+    }
+
 private:
     template <typename R>
     friend class detail::ForwardValue;
@@ -940,10 +1272,134 @@ public:
         return Future<void>(m_future);
     }
 
+    /**
+     * Sets the handler to run when a consumer interrupts the future, e.g. by
+     * Future::cancel() or the deadline of Future::within(). It is usually used to stop
+     * the work and satisfy the future with the interrupt. If the future has already been
+     * interrupted the handler is run immediately. A new handler replaces the old one,
+     * and handlers are dropped once the future is satisfied.
+     *
+     * \throws nothing
+     */
+    void setInterruptHandler(const Callback<void(const std::exception_ptr&)>& handler)
+    {
+        m_future->setInterruptHandler(handler);
+    }
+
+    /**
+     * Returns true if a consumer has interrupted the future. It can be polled by
+     * long-running producers as a cancellation token.
+     *
+     * \throws nothing
+     */
+    bool isInterrupted() const
+    {
+        return m_future->isInterrupted();
+    }
+
 private:
     std::shared_ptr<detail::FutureObjectInterface<void>> m_future;
 };
 
+namespace detail {
+
+// Gives the combinators of futures (see when_all.h) direct access to the underlying
+// future objects, so that they can register callbacks without the promise and the
+// SequentialCallback that then() creates for every future.
+struct FutureAccess {
+    template <typename T>
+    static const std::shared_ptr<FutureObjectInterface<T>>& getObject(const Future<T>& future)
+    {
+        return future.m_future;
+    }
+
+    template <typename T>
+    static void registerCallback(const Future<T>& future,
+                                 const typename FutureObjectInterface<T>::CallbackType& callback)
+    {
+        if (!future.m_future) throw FutureUninitialized();
+        future.m_future->registerCallback(callback);
+    }
+
+    template <typename T>
+    static Future<T> makeFuture(const std::shared_ptr<FutureObjectInterface<T>>& future)
+    {
+        return Future<T>(future);
+    }
+};
+
+// Callback implementation for Future::within(). Either the future or the timer wins,
+// and the other is ignored.
+template <typename T>
+class WithinCallback {
+public:
+    // \throws std::bad_alloc if memory is not available.
+    WithinCallback(const Promise<T>& promise, const std::weak_ptr<InterruptibleFutureObject>& future)
+        : m_is_done(false),
+          m_promise(promise),
+          m_future(future),
+          m_timeout(std::make_exception_ptr(FutureTimeoutException()))
+    {
+    }
+
+    void on_future(const std::shared_ptr<FutureObjectInterface<T>>& future)
+    {
+        if (m_is_done.exchange(true)) return;
+        TimerQueue::instance().cancel(m_timer);
+        ForwardValue<T>(m_promise).template run<T>(FutureAccess::makeFuture(future));
+    }
+
+    void on_timeout()
+    {
+        if (m_is_done.exchange(true)) return;
+        m_promise.setException(m_timeout);
+        forwardInterrupt(m_future, m_timeout);
+    }
+
+    // Set before the callback is registered on the future, and never changed after.
+    TimerQueue::Handle m_timer;
+
+private:
+    std::atomic<bool> m_is_done;
+    Promise<T> m_promise;
+    std::weak_ptr<InterruptibleFutureObject> m_future;
+    std::exception_ptr m_timeout;
+
+    DISALLOW_COPY_AND_ASSIGN(WithinCallback);
+};
+
+template <typename T>
+Future<T> within(const std::shared_ptr<FutureObjectInterface<T>>& future, int64_t milliseconds)
+{
+    if (!future) throw FutureUninitialized();
+
+    Promise<T> promise;
+    promise.setInterruptHandler(wsd::bind(&forwardInterrupt, std::weak_ptr<InterruptibleFutureObject>(future)));
+    std::shared_ptr<WithinCallback<T>> within_callback(new WithinCallback<T>(promise, future));
+    within_callback->m_timer = TimerQueue::instance().schedule(
+            milliseconds, wsd::bind(&WithinCallback<T>::on_timeout, wsd::shared(within_callback)));
+    try {
+        future->registerCallback(wsd::bind(&WithinCallback<T>::on_future, wsd::shared(within_callback)));
+    } catch (...) {
+        TimerQueue::instance().cancel(within_callback->m_timer);
+        throw;
+    }
+    return promise.getFuture();
+}
+
+}  // namespace detail
+
+template <typename T>
+Future<T> Future<T>::within(int64_t milliseconds) const
+{
+    return detail::within(this->m_future, milliseconds);
+}
+
+inline Future<void> Future<void>::within(int64_t milliseconds) const
+{
+    return detail::within(this->m_future, milliseconds);
+}
+
 }  // namespace wsd
 
 #endif  // __PROMISE_H__
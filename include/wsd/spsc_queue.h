@@ -0,0 +1,215 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+// A bounded single-producer single-consumer queue.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "wsd/detail/cache_line.h"
+#include "wsd/detail/waiters.h"
+
+namespace wsd {
+
+// A ring buffer for exactly one producer thread and one consumer thread. Each side
+// owns one index and keeps a cached copy of the other's, so it only reads the cache
+// line written by the other side when the cached copy says the queue is full, or
+// empty. Pushing or popping is then a few plain accesses and one release store, and
+// the batch versions amortize that store and the wakeup check over many elements.
+//
+//   wsd::SpscQueue<Item> queue(1024);
+//
+//   // Producer:                       // Consumer:
+//   queue.PushN(items, n);             size_t n = queue.PopN(items, kMaxItems);
+template <typename T>
+class SpscQueue final {
+public:
+    static_assert(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+                  "elements should be nothrow movable");
+
+    // The capacity is rounded up to a power of two, and is at least 2.
+    explicit SpscQueue(size_t capacity) : m_mask(RoundUpToPowerOfTwo(capacity) - 1)
+    {
+        m_slots.reset(new Slot[m_mask + 1]);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    void operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue()
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        for (size_t i = m_head.load(std::memory_order_relaxed); i != tail; ++i) {
+            ValueAt(i)->~T();
+        }
+    }
+
+    size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+    // The following are called by the producer only.
+
+    // Returns false if the queue is full. `value' is moved from only on success.
+    bool TryPush(T&& value)
+    {
+        return TryPushN(&value, 1) == 1;
+    }
+
+    // Throws whatever copying `value' throws.
+    bool TryPush(const T& value)
+    {
+        T copy(value);
+        return TryPush(std::move(copy));
+    }
+
+    // Moves up to `n' elements from `values' into the queue, and returns the number
+    // moved, which is less than `n' if the queue gets full.
+    size_t TryPushN(T* values, size_t n)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t free = capacity() - (tail - m_cached_head);
+        if (free < n) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            free = capacity() - (tail - m_cached_head);
+        }
+        n = std::min(n, free);
+        if (n == 0) {
+            return 0;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            new (ValueAt(tail + i)) T(std::move(values[i]));
+        }
+        m_tail.store(tail + n, std::memory_order_release);
+        m_not_empty.Notify();
+        return n;
+    }
+
+    // Blocks while the queue is full.
+    void Push(T&& value)
+    {
+        PushN(&value, 1);
+    }
+
+    // Throws whatever copying `value' throws.
+    void Push(const T& value)
+    {
+        T copy(value);
+        Push(std::move(copy));
+    }
+
+    // Moves all of `values' into the queue, blocking whenever it is full.
+    void PushN(T* values, size_t n)
+    {
+        while (n > 0) {
+            size_t pushed = TryPushN(values, n);
+            values += pushed;
+            n -= pushed;
+            if (n > 0) {
+                m_not_full.Wait([this]() {
+                    return m_head.load(std::memory_order_acquire) != m_tail.load(std::memory_order_relaxed) - capacity();
+                });
+            }
+        }
+    }
+
+    // The following are called by the consumer only.
+
+    // Returns false if the queue is empty.
+    bool TryPop(T* value)
+    {
+        return TryPopN(value, 1) == 1;
+    }
+
+    // Moves up to `n' elements into `values', and returns the number moved, which is
+    // less than `n' if the queue gets empty.
+    size_t TryPopN(T* values, size_t n)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t available = m_cached_tail - head;
+        if (available < n) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            available = m_cached_tail - head;
+        }
+        n = std::min(n, available);
+        if (n == 0) {
+            return 0;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            T* p = ValueAt(head + i);
+            values[i] = std::move(*p);
+            p->~T();
+        }
+        m_head.store(head + n, std::memory_order_release);
+        m_not_full.Notify();
+        return n;
+    }
+
+    // Blocks while the queue is empty.
+    void Pop(T* value)
+    {
+        PopN(value, 1);
+    }
+
+    // Moves up to `n' elements into `values', blocking until there is at least one if
+    // `n' is positive. Returns the number moved.
+    size_t PopN(T* values, size_t n)
+    {
+        if (n == 0) {
+            return 0;
+        }
+        while (true) {
+            size_t popped = TryPopN(values, n);
+            if (popped > 0) {
+                return popped;
+            }
+            m_not_empty.Wait([this]() {
+                return m_tail.load(std::memory_order_acquire) != m_head.load(std::memory_order_relaxed);
+            });
+        }
+    }
+
+private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+    static size_t RoundUpToPowerOfTwo(size_t n)
+    {
+        size_t size = 2;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    T* ValueAt(size_t index) const
+    {
+        return reinterpret_cast<T*>(&m_slots[index & m_mask]);
+    }
+
+    const size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+
+    // Each side writes its own cache line.
+    char m_pad0[detail::kCacheLineSize];
+    std::atomic<size_t> m_tail{0};  // written by the producer
+    size_t m_cached_head = 0;       // the producer's copy of m_head
+    char m_pad1[detail::kCacheLineSize];
+    std::atomic<size_t> m_head{0};  // written by the consumer
+    size_t m_cached_tail = 0;       // the consumer's copy of m_tail
+    char m_pad2[detail::kCacheLineSize];
+
+    detail::Waiters m_not_full;
+    detail::Waiters m_not_empty;
+};
+
+}  // namespace wsd
@@ -7,8 +7,13 @@
 #ifndef __WHEN_ALL_H__
 #define __WHEN_ALL_H__
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iterator>
 #include <mutex>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "promise.h"
@@ -17,8 +22,66 @@ namespace wsd {
 
 namespace detail {
 
-// Callback implementation for parallel composition of futures.
+// Keeps weak references to the input futures of a combinator, so that interrupts can
+// be forwarded to them without keeping them alive.
+class InputFutures {
+public:
+    typedef std::weak_ptr<InterruptibleFutureObject> WeakFuturePtr;
+
+    // \throws std::bad_alloc if memory is not available.
+    explicit InputFutures(size_t n) : m_cancel(std::make_exception_ptr(FutureCancelledException()))
+    {
+        m_futures.reserve(n);
+    }
+
+    // All the futures must be added before any callback is registered on them.
+    template <typename T>
+    void add(const Future<T>& future)
+    {
+        m_futures.push_back(WeakFuturePtr(FutureAccess::getObject(future)));
+    }
+
+    void raise(const std::exception_ptr& e) const
+    {
+        for (std::vector<WeakFuturePtr>::const_iterator it = m_futures.begin(), end = m_futures.end();
+             it != end; ++it) {
+            forwardInterrupt(*it, e);
+        }
+    }
+
+    // Cancels the futures not done yet, once the combinator no longer needs them.
+    void cancel() const
+    {
+        raise(m_cancel);
+    }
+
+private:
+    std::vector<WeakFuturePtr> m_futures;
+    std::exception_ptr m_cancel;
 
+    DISALLOW_COPY_AND_ASSIGN(InputFutures);
+};
+
+// Adds the input futures of a combinator, and forwards the interrupts to the
+// combined future to them.
+//
+// \throws std::bad_alloc if memory is not available.
+template <typename R, typename InputIterator>
+std::shared_ptr<InputFutures> makeInputFutures(Promise<R>& promise, InputIterator first, InputIterator last)
+{
+    std::shared_ptr<InputFutures> inputs(new InputFutures(std::distance(first, last)));
+    for (; first != last; ++first) {
+        inputs->add(*first);
+    }
+    promise.setInterruptHandler(wsd::bind(&InputFutures::raise, wsd::shared(inputs)));
+    return inputs;
+}
+
+// Callback implementation for parallel composition of futures.
+//
+// Each future is recorded in its own slot of `m_waiting_futures', so recording
+// needs no locking. The number of non-satisfied futures is counted down with a
+// single atomic, and the one that brings it to zero satisfies the promise.
 template <typename FutureAllValueType>
 struct ParallelAllCallbackBase {
 public:
@@ -33,10 +96,25 @@ public:
     {
     }
 
-    size_t m_number_of_non_satisfied;
+    // Must be called once after each future is recorded.
+    void on_recorded()
+    {
+        // The acquire-release ordering makes sure the last one sees all the futures
+        // recorded by the others.
+        size_t old = m_number_of_non_satisfied.fetch_sub(1, std::memory_order_acq_rel);
+        assert(old > 0);
+        if (old == 1) {
+            try {
+                m_promise_all.setValue(m_waiting_futures);
+            } catch (...) {
+                m_promise_all.setException(std::current_exception());
+            }
+        }
+    }
+
+    std::atomic<size_t> m_number_of_non_satisfied;
     PromiseAll m_promise_all;
     FutureAllValueType m_waiting_futures;
-    std::mutex m_mutex;
 
 private:
     DISALLOW_COPY_AND_ASSIGN(ParallelAllCallbackBase);
@@ -60,22 +138,12 @@ public:
     {
     }
 
-    template <int N>
-    void on_future(const typename std::tuple_element<N, FutureAllValueType>::type& future)
+    template <size_t N, typename T>
+    void on_future(const std::shared_ptr<FutureObjectInterface<T>>& future)
     {
         // Note: this future must be recorded no matter what exception is thrown.
-        std::unique_lock<std::mutex> lock(this->m_mutex);
-        std::get<N>(this->m_waiting_futures) = future;
-        assert(this->m_number_of_non_satisfied > 0);
-        if (--this->m_number_of_non_satisfied == 0) {
-            lock.unlock();
-            try {
-                this->m_promise_all.setValue(this->m_waiting_futures);
-            } catch (...) {
-                this->m_promise_all.setException(std::current_exception());
-            }
-            return;
-        }
+        std::get<N>(this->m_waiting_futures) = FutureAccess::makeFuture(future);
+        this->on_recorded();
     }
 
 private:
@@ -83,13 +151,14 @@ private:
 };
 
 // This implementation is specialized for std::vector<wsd::Future<> >.
-template <typename FutureType>
-class ParallelAllCallback<std::vector<FutureType>> : private ParallelAllCallbackBase<std::vector<FutureType>> {
+template <typename T>
+class ParallelAllCallback<std::vector<Future<T>>> : private ParallelAllCallbackBase<std::vector<Future<T>>> {
 public:
-    typedef typename ParallelAllCallbackBase<std::vector<FutureType>>::PromiseAll PromiseAll;
+    typedef typename ParallelAllCallbackBase<std::vector<Future<T>>>::PromiseAll PromiseAll;
 
+    // \throws std::bad_alloc if memory is not available.
     ParallelAllCallback(const PromiseAll& promise_all, size_t number_of_non_satisfied)
-        : ParallelAllCallbackBase<std::vector<FutureType>>(promise_all, number_of_non_satisfied)
+        : ParallelAllCallbackBase<std::vector<Future<T>>>(promise_all, number_of_non_satisfied)
     {
         this->m_waiting_futures.resize(number_of_non_satisfied);
     }
@@ -98,85 +167,271 @@ public:
     {
     }
 
-    void on_future(const FutureType& future, size_t idx)
+    void on_future(size_t idx, const std::shared_ptr<FutureObjectInterface<T>>& future)
     {
         // Note: this future must be recorded no matter what exception is thrown.
         assert(idx < this->m_waiting_futures.size());
+        this->m_waiting_futures[idx] = FutureAccess::makeFuture(future);
+        this->on_recorded();
+    }
 
-        std::unique_lock<std::mutex> lock(this->m_mutex);
-        this->m_waiting_futures[idx] = future;
-        assert(this->m_number_of_non_satisfied > 0);
-        if (--this->m_number_of_non_satisfied == 0) {
+private:
+    DISALLOW_COPY_AND_ASSIGN(ParallelAllCallback);
+};
+
+// Registers the callbacks of the tuple form of whenAll() on each future, and forwards
+// the interrupts to the combined future to them.
+template <typename WhenAllCallback, size_t... Is, typename... Ts>
+void registerParallelAllCallback(typename WhenAllCallback::PromiseAll& promise_all,
+                                 const std::shared_ptr<WhenAllCallback>& when_all_callback,
+                                 IndexSequence<Is...>,
+                                 const Future<Ts>&... futures)
+{
+    // The elements of a braced-init-list are evaluated in order.
+    std::shared_ptr<InputFutures> inputs(new InputFutures(sizeof...(Ts)));
+    int dummy1[] = {0, (inputs->add(futures), 0)...};
+    (void) dummy1;
+    promise_all.setInterruptHandler(wsd::bind(&InputFutures::raise, wsd::shared(inputs)));
+
+    int dummy2[] = {0, (FutureAccess::registerCallback(futures, wsd::bind(&WhenAllCallback::template on_future<Is, Ts>,
+                                                                           wsd::shared(when_all_callback))),
+                        0)...};
+    (void) dummy2;
+}
+
+// Callback implementation for whenAny(). Only the first future done is recorded, and
+// the others are cancelled.
+template <typename T>
+class ParallelAnyCallback {
+public:
+    typedef std::pair<size_t, Future<T>> FutureAnyValueType;
+    typedef Promise<FutureAnyValueType> PromiseAny;
+
+    ParallelAnyCallback(const PromiseAny& promise_any, const std::shared_ptr<InputFutures>& inputs)
+        : m_is_done(false), m_promise_any(promise_any), m_inputs(inputs)
+    {
+    }
+
+    void on_future(size_t idx, const std::shared_ptr<FutureObjectInterface<T>>& future)
+    {
+        if (m_is_done.exchange(true)) {
+            // Some other future has won.
+            return;
+        }
+        try {
+            m_promise_any.setValue(FutureAnyValueType(idx, FutureAccess::makeFuture(future)));
+        } catch (...) {
+            m_promise_any.setException(std::current_exception());
+        }
+        m_inputs->cancel();
+    }
+
+private:
+    std::atomic<bool> m_is_done;
+    PromiseAny m_promise_any;
+    std::shared_ptr<InputFutures> m_inputs;
+
+    DISALLOW_COPY_AND_ASSIGN(ParallelAnyCallback);
+};
+
+// Callback implementation for whenN(). The first `n' futures done are recorded in
+// the order they are done, and the others are cancelled.
+template <typename T>
+class ParallelNCallback {
+public:
+    typedef std::vector<std::pair<size_t, Future<T>>> FutureNValueType;
+    typedef Promise<FutureNValueType> PromiseN;
+
+    // \throws std::bad_alloc if memory is not available.
+    ParallelNCallback(const PromiseN& promise_n, size_t n, const std::shared_ptr<InputFutures>& inputs)
+        : m_n(n), m_promise_n(promise_n), m_inputs(inputs)
+    {
+        // Reserve all the space needed so that recording a future never throws.
+        m_done_futures.reserve(n);
+    }
+
+    void on_future(size_t idx, const std::shared_ptr<FutureObjectInterface<T>>& future)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_done_futures.size() >= m_n) {
+            // Already satisfied.
+            return;
+        }
+        m_done_futures.push_back(std::make_pair(idx, FutureAccess::makeFuture(future)));
+        if (m_done_futures.size() < m_n) {
+            return;
+        }
+
+        // No more futures will be recorded, so it is safe to read them without locking.
+        lock.unlock();
+        try {
+            m_promise_n.setValue(m_done_futures);
+        } catch (...) {
+            m_promise_n.setException(std::current_exception());
+        }
+        m_inputs->cancel();
+    }
+
+private:
+    const size_t m_n;
+    PromiseN m_promise_n;
+    std::shared_ptr<InputFutures> m_inputs;
+    FutureNValueType m_done_futures;
+    std::mutex m_mutex;
+
+    DISALLOW_COPY_AND_ASSIGN(ParallelNCallback);
+};
+
+// Callback implementation for collectAll(). It is satisfied with all the values if
+// all futures have values, or with the first exception as soon as any of the futures
+// fails, in which case the others are cancelled.
+template <typename T>
+class CollectAllCallback {
+public:
+    typedef Promise<std::vector<T>> PromiseAll;
+
+    // \throws std::bad_alloc if memory is not available.
+    CollectAllCallback(const PromiseAll& promise_all,
+                       size_t number_of_non_satisfied,
+                       const std::shared_ptr<InputFutures>& inputs)
+        : m_number_of_non_satisfied(number_of_non_satisfied),
+          m_is_done(false),
+          m_promise_all(promise_all),
+          m_inputs(inputs)
+    {
+        m_waiting_futures.resize(number_of_non_satisfied);
+    }
+
+    void on_future(size_t idx, const std::shared_ptr<FutureObjectInterface<T>>& future)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_is_done) {
+            return;
+        }
+        assert(idx < m_waiting_futures.size());
+        if (future->hasException()) {
+            // Fail fast, and drop the values collected so far.
+            m_is_done = true;
+            std::vector<Future<T>>().swap(m_waiting_futures);
             lock.unlock();
             try {
-                this->m_promise_all.setValue(this->m_waiting_futures);
+                future->get();
             } catch (...) {
-                this->m_promise_all.setException(std::current_exception());
+                m_promise_all.setException(std::current_exception());
             }
+            m_inputs->cancel();
+            return;
+        }
+        m_waiting_futures[idx] = FutureAccess::makeFuture(future);
+        assert(m_number_of_non_satisfied > 0);
+        if (--m_number_of_non_satisfied > 0) {
             return;
         }
+        m_is_done = true;
+        lock.unlock();
+
+        try {
+            std::vector<T> values;
+            values.reserve(m_waiting_futures.size());
+            for (typename std::vector<Future<T>>::const_iterator it = m_waiting_futures.begin(),
+                                                                 end = m_waiting_futures.end();
+                 it != end; ++it) {
+                values.push_back(it->get());
+            }
+            m_promise_all.setValue(values);
+        } catch (...) {
+            m_promise_all.setException(std::current_exception());
+        }
     }
 
 private:
-    DISALLOW_COPY_AND_ASSIGN(ParallelAllCallback);
+    size_t m_number_of_non_satisfied;
+    bool m_is_done;
+    PromiseAll m_promise_all;
+    std::shared_ptr<InputFutures> m_inputs;
+    std::vector<Future<T>> m_waiting_futures;
+    std::mutex m_mutex;
+
+    DISALLOW_COPY_AND_ASSIGN(CollectAllCallback);
 };
 
-// A helper class to notify ParallelAllCallback<std::vector<> > which future is done.
-template <typename T>
-class VectorParallelCallback {
+// Shared by all the futures waited by waitAll(), so that the waiting thread blocks on
+// a single condition variable. It outlives waitAll() if some futures are not
+// satisfied before the deadline.
+class WaitAllState {
 public:
-    VectorParallelCallback(const std::shared_ptr<ParallelAllCallback<std::vector<Future<T>>>>& cb, size_t idx)
-        : m_parallel_callback(cb), m_idx(idx)
+    // Starts with one for the registering thread, which calls done() once all the
+    // callbacks are registered.
+    WaitAllState() : m_number_of_non_satisfied(1)
+    {
+    }
+
+    void add()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_number_of_non_satisfied;
+    }
+
+    template <typename T>
+    void on_future(const std::shared_ptr<FutureObjectInterface<T>>&)
     {
+        done();
     }
 
-    void on_future(const Future<T>& future)
+    void done()
     {
-        m_parallel_callback->on_future(future, m_idx);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        assert(m_number_of_non_satisfied > 0);
+        if (--m_number_of_non_satisfied == 0) m_cond.notify_one();
+    }
+
+    bool waitUntil(const TimePoint& deadline)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_number_of_non_satisfied > 0) {
+            if (m_cond.wait_until(lock, deadline) == std::cv_status::timeout) return m_number_of_non_satisfied == 0;
+        }
+        return true;
     }
 
 private:
-    std::shared_ptr<ParallelAllCallback<std::vector<Future<T>>>> m_parallel_callback;
-    size_t m_idx;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;  // predicate: m_number_of_non_satisfied == 0
+    size_t m_number_of_non_satisfied;
+
+    DISALLOW_COPY_AND_ASSIGN(WaitAllState);
 };
 
 }  // namespace detail
 
 /**
  * Parallelly composite two or more futues. Only when all futures are satisfied is
- * the composited future satisfied.
+ * the composited future satisfied. Interrupts to the composited future are forwarded
+ * to all the futures.
+ *
+ * \throws std::bad_alloc if memory is not available, or FutureUninitialized if any
+ *     of the futures is not initialized.
  */
-template <typename T1, typename T2>
-Future<std::tuple<Future<T1>, Future<T2>>> whenAll(const Future<T1>& future1, const Future<T2>& future2)
+template <typename... Ts>
+Future<std::tuple<Future<Ts>...>> whenAll(const Future<Ts>&... futures)
 {
-    typedef std::tuple<Future<T1>, Future<T2>> FutureAllValueType;
-    typedef Promise<FutureAllValueType> PromiseAll;
-    typedef detail::ParallelAllCallback<FutureAllValueType> WhenAllCallback;
-
-    PromiseAll promise_all;
-    std::shared_ptr<WhenAllCallback> future_callback(new WhenAllCallback(promise_all));
-    future1.then(wsd::bind(&WhenAllCallback::template on_future<0>, wsd::shared(future_callback)));
-    future2.then(wsd::bind(&WhenAllCallback::template on_future<1>, wsd::shared(future_callback)));
-    return promise_all.getFuture();
-}
+    static_assert(sizeof...(Ts) >= 2, "whenAll() requires at least two futures");
 
-template <typename T1, typename T2, typename T3>
-Future<std::tuple<Future<T1>, Future<T2>, Future<T3>>> whenAll(const Future<T1>& future1,
-                                                               const Future<T2>& future2,
-                                                               const Future<T3>& future3)
-{
-    typedef std::tuple<Future<T1>, Future<T2>, Future<T3>> FutureAllValueType;
+    typedef std::tuple<Future<Ts>...> FutureAllValueType;
     typedef Promise<FutureAllValueType> PromiseAll;
     typedef detail::ParallelAllCallback<FutureAllValueType> WhenAllCallback;
 
     PromiseAll promise_all;
     std::shared_ptr<WhenAllCallback> future_callback(new WhenAllCallback(promise_all));
-    future1.then(wsd::bind(&WhenAllCallback::template on_future<0>, wsd::shared(future_callback)));
-    future2.then(wsd::bind(&WhenAllCallback::template on_future<1>, wsd::shared(future_callback)));
-    future3.then(wsd::bind(&WhenAllCallback::template on_future<2>, wsd::shared(future_callback)));
+    detail::registerParallelAllCallback(promise_all, future_callback,
+                                        typename detail::MakeIndexSequence<sizeof...(Ts)>::type(), futures...);
     return promise_all.getFuture();
 }
 
+/**
+ * The iterator form of whenAll(). Only one allocation is made for the whole range
+ * besides the callback registered on each future.
+ */
 template <typename T, typename InputIterator>
 Future<std::vector<Future<T>>> whenAll(InputIterator first, InputIterator last)
 {
@@ -188,15 +443,133 @@ Future<std::vector<Future<T>>> whenAll(InputIterator first, InputIterator last)
 
     PromiseAll promise_all;
     std::shared_ptr<WhenAllCallback> when_all_callback(new WhenAllCallback(promise_all, std::distance(first, last)));
+    detail::makeInputFutures(promise_all, first, last);
     size_t i;
 
     for (i = 0; first != last; ++first, ++i) {
-        first->then(wsd::bind(&detail::VectorParallelCallback<T>::on_future,
-                              wsd::owned(new detail::VectorParallelCallback<T>(when_all_callback, i))));
+        detail::FutureAccess::registerCallback(
+                *first, wsd::bind(&WhenAllCallback::on_future, wsd::shared(when_all_callback), i));
     }
     return promise_all.getFuture();
 }
 
+/**
+ * Returns a future which is satisfied as soon as any of the futures in the range
+ * [first, last) is satisfied, either with a value or an exception. Its value is the
+ * index of that future in the range and the future itself. The other futures are
+ * cancelled then (see Future::cancel()).
+ *
+ * \pre first != last
+ * \throws std::bad_alloc if memory is not available.
+ */
+template <typename T, typename InputIterator>
+Future<std::pair<size_t, Future<T>>> whenAny(InputIterator first, InputIterator last)
+{
+    assert(first != last);
+
+    typedef detail::ParallelAnyCallback<T> WhenAnyCallback;
+    typedef typename WhenAnyCallback::PromiseAny PromiseAny;
+
+    PromiseAny promise_any;
+    std::shared_ptr<WhenAnyCallback> when_any_callback(
+            new WhenAnyCallback(promise_any, detail::makeInputFutures(promise_any, first, last)));
+    for (size_t i = 0; first != last; ++first, ++i) {
+        detail::FutureAccess::registerCallback(
+                *first, wsd::bind(&WhenAnyCallback::on_future, wsd::shared(when_any_callback), i));
+    }
+    return promise_any.getFuture();
+}
+
+/**
+ * Returns a future which is satisfied as soon as `n' of the futures in the range
+ * [first, last) are satisfied, either with values or exceptions. Its value contains
+ * those futures and their indices in the range, in the order they are satisfied. The
+ * other futures are cancelled then.
+ *
+ * It can be used for quorum reads, or hedged requests when n is 1.
+ *
+ * \pre 0 < n <= std::distance(first, last)
+ * \throws std::bad_alloc if memory is not available.
+ */
+template <typename T, typename InputIterator>
+Future<std::vector<std::pair<size_t, Future<T>>>> whenN(InputIterator first, InputIterator last, size_t n)
+{
+    assert(n > 0 && n <= static_cast<size_t>(std::distance(first, last)));
+
+    typedef detail::ParallelNCallback<T> WhenNCallback;
+    typedef typename WhenNCallback::PromiseN PromiseN;
+
+    PromiseN promise_n;
+    std::shared_ptr<WhenNCallback> when_n_callback(
+            new WhenNCallback(promise_n, n, detail::makeInputFutures(promise_n, first, last)));
+    for (size_t i = 0; first != last; ++first, ++i) {
+        detail::FutureAccess::registerCallback(
+                *first, wsd::bind(&WhenNCallback::on_future, wsd::shared(when_n_callback), i));
+    }
+    return promise_n.getFuture();
+}
+
+/**
+ * Returns a future which is satisfied with the values of all the futures in the range
+ * [first, last) in the same order, once all of them have values. Unlike whenAll() it
+ * fails fast: as soon as any of the futures is satisfied with an exception the
+ * returned future is satisfied with that exception and the rest are cancelled.
+ *
+ * \pre first != last, and T is CopyConstructible and not void.
+ * \throws std::bad_alloc if memory is not available.
+ */
+template <typename T, typename InputIterator>
+Future<std::vector<T>> collectAll(InputIterator first, InputIterator last)
+{
+    assert(first != last);
+
+    typedef detail::CollectAllCallback<T> CollectCallback;
+    typedef typename CollectCallback::PromiseAll PromiseAll;
+
+    PromiseAll promise_all;
+    std::shared_ptr<CollectCallback> collect_callback(new CollectCallback(
+            promise_all, std::distance(first, last), detail::makeInputFutures(promise_all, first, last)));
+    for (size_t i = 0; first != last; ++first, ++i) {
+        detail::FutureAccess::registerCallback(
+                *first, wsd::bind(&CollectCallback::on_future, wsd::shared(collect_callback), i));
+    }
+    return promise_all.getFuture();
+}
+
+/**
+ * Blocks until all the futures in the range [first, last) are satisfied or `deadline'
+ * is reached. Returns true if all of them are satisfied, either with values or
+ * exceptions. Unlike waiting for the futures one by one, the calling thread blocks on
+ * one condition variable shared by all the futures.
+ *
+ * \throws std::bad_alloc, or FutureUninitialized if any future is not initialized.
+ */
+template <typename T, typename InputIterator, typename Clock, typename Duration>
+bool waitAll(InputIterator first, InputIterator last, const std::chrono::time_point<Clock, Duration>& deadline)
+{
+    std::shared_ptr<detail::WaitAllState> state(new detail::WaitAllState);
+    for (; first != last; ++first) {
+        // Futures already satisfied need no callbacks.
+        if (first->isDone()) continue;
+        state->add();
+        detail::FutureAccess::registerCallback(*first,
+                                               wsd::bind(&detail::WaitAllState::on_future<T>, wsd::shared(state)));
+    }
+    state->done();
+    return state->waitUntil(detail::toSteadyTimePoint(deadline));
+}
+
+/**
+ * Like waitAll(first, last, deadline), but blocks for at most `timeout'.
+ *
+ * \throws std::bad_alloc, or FutureUninitialized if any future is not initialized.
+ */
+template <typename T, typename InputIterator, typename Rep, typename Period>
+bool waitAll(InputIterator first, InputIterator last, const std::chrono::duration<Rep, Period>& timeout)
+{
+    return waitAll<T>(first, last, std::chrono::steady_clock::now() + timeout);
+}
+
 }  // namespace wsd
 
 #endif  // __WHEN_ALL_H__
@@ -0,0 +1,78 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "wsd/bitonic.h"
+#include "wsd/ms_queue.h"
+#include "wsd/util.h"
+
+namespace wsd {
+
+// Spreads tasks over a fixed number of queues, e.g. one per worker thread. The queue
+// of each task is picked by a bitonic network rather than by a shared round-robin
+// counter, so submitters contend on different balancers. The network keeps the queues
+// balanced: whenever no task is being submitted, each queue has been given as many
+// tasks as the next one, or one more.
+//
+//   wsd::WorkDistributor<Task> distributor(kWorkers);
+//   distributor.Submit(task);          // any thread
+//   distributor.Take(worker, &task);   // worker i takes from queue i
+template <typename T>
+class WorkDistributor final {
+public:
+    // `num_queues' is a power of two.
+    explicit WorkDistributor(int num_queues) : m_bitonic(num_queues), m_queues(new MsQueue<T>[num_queues])
+    {
+    }
+
+    WorkDistributor(const WorkDistributor&) = delete;
+    void operator=(const WorkDistributor&) = delete;
+
+    int num_queues() const
+    {
+        return m_bitonic.width();
+    }
+
+    // Returns the queue given the task.
+    int Submit(T task)
+    {
+        int queue = m_bitonic.Traverse(ThreadId() % m_bitonic.width());
+        m_queues[queue].Push(std::move(task));
+        return queue;
+    }
+
+    // Returns false if queue `queue' is empty. Throws std::invalid_argument if `queue' is
+    // not in [0, num_queues()).
+    bool TryTake(int queue, T* task)
+    {
+        return GetQueue(queue).TryPop(task);
+    }
+
+    // Blocks until queue `queue' has a task. Throws as TryTake().
+    void Take(int queue, T* task)
+    {
+        GetQueue(queue).Pop(task);
+    }
+
+private:
+    MsQueue<T>& GetQueue(int queue)
+    {
+        if (queue < 0 || queue >= m_bitonic.width()) {
+            throw std::invalid_argument("bad queue");
+        }
+        return m_queues[queue];
+    }
+
+    Bitonic m_bitonic;
+    std::unique_ptr<MsQueue<T>[]> m_queues;
+};
+
+}  // namespace wsd
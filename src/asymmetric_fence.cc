@@ -0,0 +1,87 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "wsd/asymmetric_fence.h"
+
+#include <assert.h>
+
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace wsd {
+
+namespace detail {
+
+std::atomic<bool> g_heavy_fence_is_membarrier{false};
+
+}  // namespace detail
+
+namespace {
+
+#if defined(__linux__) && defined(SYS_membarrier)
+
+bool RegisterMembarrier()
+{
+    long cmds = syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0);
+    if (cmds < 0 || !(cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED)) {
+        return false;
+    }
+    return syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+}
+
+bool Membarrier()
+{
+    return syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0) == 0;
+}
+
+#else
+
+bool RegisterMembarrier()
+{
+    return false;
+}
+
+bool Membarrier()
+{
+    return false;
+}
+
+#endif
+
+bool UseMembarrier()
+{
+    // Light fences stay full fences until this is done, and heavy fences wait for it.
+    static const bool use_membarrier = []() {
+        bool registered = RegisterMembarrier();
+        detail::g_heavy_fence_is_membarrier.store(registered, std::memory_order_relaxed);
+        return registered;
+    }();
+    return use_membarrier;
+}
+
+}  // namespace
+
+void PrepareAsymmetricFences()
+{
+    UseMembarrier();
+}
+
+void AsymmetricHeavyFence()
+{
+    if (UseMembarrier()) {
+        // Only fails for unregistered processes or unknown commands.
+        bool ok = Membarrier();
+        assert(ok);
+        (void)ok;
+    } else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+}  // namespace wsd
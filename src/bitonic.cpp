@@ -7,101 +7,79 @@
 #include "wsd/bitonic.h"
 #include <atomic>
 #include <stdexcept>
+#include <utility>
 #include <vector>
+#include "wsd/util.h"
+
+using std::vector;
 
 namespace wsd {
 
-class Balancer final {
-public:
-    Balancer()
-        : m_toggle(true)
-    {}
-
-    Balancer(const Balancer&) = delete;
-    Balancer& operator=(const Balancer&) = delete;
-    
-    int Traverse(int)
-    {
-        for (;;) {
-            bool toggle = m_toggle.load();
-            if (m_toggle.compare_exchange_weak(toggle, !toggle)) {
-                if (toggle) {
-                    return 0;
-                } else {
-                    return 1;
-                }
-            }
-        }
-    }
-    
-private:
-    std::atomic<bool> m_toggle;
-};
-
-class Merger final {
-public:
-    explicit Merger(int width)
-        : m_width(width)
-    {
-        if ((width % 2) != 0) {
-            throw std::invalid_argument("width should be even");
-        }
-        
-        m_layer.reset(new Balancer[width/2]);
-        if (width > 2) {
-            m_half0.reset(new Merger(width/2));
-            m_half1.reset(new Merger(width/2));
-        }
+namespace {
+
+using detail::LayeredNetwork;
+
+int Depth(int width)
+{
+    int log = LayeredNetwork::Log2(width);
+    return log * (log + 1) / 2;
+}
+
+vector<int> AddMerger(LayeredNetwork* network, const vector<int>& inputs, int layer);
+
+// Bitonic[n] is two Bitonic[n/2] side by side, followed by a Merger[n] of their
+// outputs. Returns the positions of the outputs.
+vector<int> AddBitonic(LayeredNetwork* network, const vector<int>& inputs, int layer)
+{
+    size_t n = inputs.size();
+    if (n == 2) {
+        return AddMerger(network, inputs, layer);
     }
+    vector<int> half0 = AddBitonic(network, vector<int>(inputs.begin(), inputs.begin() + n/2), layer);
+    vector<int> half1 = AddBitonic(network, vector<int>(inputs.begin() + n/2, inputs.end()), layer);
+    half0.insert(half0.end(), half1.begin(), half1.end());
+    return AddMerger(network, half0, layer + Depth(static_cast<int>(n) / 2));
+}
 
-    Merger(const Merger&) = delete;
-    Merger& operator=(const Merger&) = delete;
-
-    int Traverse(int input)
-    {
-        if (input > m_width) {
-            throw std::invalid_argument("bad input");
-        }
-
-        int output = 0;
-        if (m_width > 2) {
-            if (input < m_width/2) {
-                if ((input % 2) == 0) {
-                    output = m_half0->Traverse(input/2);
-                } else {
-                    output = m_half1->Traverse(input/2);
-                }
-            } else {
-                if ((input%2) == 0) {
-                    output = m_half1->Traverse(input/2);
-                } else {
-                    output = m_half0->Traverse(input / 2);
-                }
-            }
-        }
-        output = m_layer[output].Traverse(0) + output * 2;
-        return output;
+// Merger[n] merges the even inputs of its top half and the odd ones of its bottom
+// half in one Merger[n/2], the others in another, and balances the outputs i of both
+// into its outputs 2i and 2i + 1.
+vector<int> AddMerger(LayeredNetwork* network, const vector<int>& inputs, int layer)
+{
+    size_t n = inputs.size();
+    if (n == 2) {
+        std::pair<int, int> outputs = network->Place(layer, inputs[0], inputs[1]);
+        return vector<int>{outputs.first, outputs.second};
     }
+    vector<int> in0(n/2);
+    vector<int> in1(n/2);
+    for (size_t i = 0; i < n/2; ++i) {
+        bool is_top = i < n/4;
+        in0[i] = inputs[is_top ? 2*i : 2*i + 1];
+        in1[i] = inputs[is_top ? 2*i + 1 : 2*i];
+    }
+    vector<int> out0 = AddMerger(network, in0, layer);
+    vector<int> out1 = AddMerger(network, in1, layer);
+    int last = layer + LayeredNetwork::Log2(static_cast<int>(n) / 2);
+    vector<int> outputs;
+    for (size_t i = 0; i < n/2; ++i) {
+        std::pair<int, int> pair = network->Place(last, out0[i], out1[i]);
+        outputs.push_back(pair.first);
+        outputs.push_back(pair.second);
+    }
+    return outputs;
+}
 
-private:
-    std::unique_ptr<Merger> m_half0;
-    std::unique_ptr<Merger> m_half1;
-    std::unique_ptr<Balancer[]> m_layer;
-    const int m_width;
-};
+}  // namespace
 
 Bitonic::Bitonic(int width)
-    : m_width(width)
+    : m_network(width, Depth(width))
 {
-    if ((width % 2) != 0) {
-        throw std::invalid_argument("width should be even");
-    }
-    
-    m_merger.reset(new Merger(width));
-    if (width > 2) {
-        m_half0.reset(new Bitonic(width/2));
-        m_half1.reset(new Bitonic(width/2));
+    vector<int> inputs(width);
+    for (int i = 0; i < width; ++i) {
+        inputs[i] = i;
     }
+    m_network.Finish(AddBitonic(&m_network, inputs, 0));
 }
 
 Bitonic::~Bitonic()
@@ -110,20 +88,24 @@ Bitonic::~Bitonic()
 
 int Bitonic::Traverse(int input)
 {
-    if (input > m_width) {
+    if (input < 0 || input >= m_network.width()) {
         throw std::invalid_argument("bad input");
     }
-    
-    int output = 0;
-    if (m_width > 2) {
-        if (input < m_width/2) {
-            output = m_half0->Traverse(input);
-        } else {
-            output = m_half1->Traverse(input - m_width / 2);
-        }
-    }
-    return m_merger->Traverse(output + input / (m_width/2) * (m_width/2));
+    return m_network.Traverse(input);
+}
+
+BitonicCounter::BitonicCounter(int width)
+    : m_bitonic(width),
+      m_wires(new Wire[width])
+{
+}
+
+uint64_t BitonicCounter::GetAndIncrement()
+{
+    // Any input wire works, but threads sticking to different ones contend less.
+    int output = m_bitonic.Traverse(ThreadId() % m_bitonic.width());
+    uint64_t round = m_wires[output].count.fetch_add(1, std::memory_order_relaxed);
+    return round * m_bitonic.width() + output;
 }
-        
 
 }  // namespace wsd
@@ -0,0 +1,165 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "wsd/counting_network.h"
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace wsd {
+
+namespace {
+
+using detail::LayeredNetwork;
+
+// Returns the positions of the outputs of a Block on the wires at `inputs'.
+std::vector<int> AddBlock(LayeredNetwork* network, const std::vector<int>& inputs, int layer)
+{
+    size_t n = inputs.size();
+    std::vector<int> wires(n);
+    for (size_t i = 0; i < n/2; ++i) {
+        std::pair<int, int> outputs = network->Place(layer, inputs[i], inputs[n-1-i]);
+        wires[i] = outputs.first;
+        wires[n-1-i] = outputs.second;
+    }
+    if (n == 2) {
+        return wires;
+    }
+    std::vector<int> top = AddBlock(network, std::vector<int>(wires.begin(), wires.begin() + n/2), layer + 1);
+    std::vector<int> bottom = AddBlock(network, std::vector<int>(wires.begin() + n/2, wires.end()), layer + 1);
+    top.insert(top.end(), bottom.begin(), bottom.end());
+    return top;
+}
+
+uint32_t NextRandom()
+{
+    static thread_local std::minstd_rand s_random(
+            static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+    return static_cast<uint32_t>(s_random());
+}
+
+enum ExchangerState { kEmpty, kWaiting, kAnswered };
+
+}  // namespace
+
+Periodic::Periodic(int width)
+    : m_network(width, LayeredNetwork::Log2(width) * LayeredNetwork::Log2(width))
+{
+    int log = LayeredNetwork::Log2(width);
+    std::vector<int> positions(width);
+    for (int i = 0; i < width; ++i) {
+        positions[i] = i;
+    }
+    for (int i = 0; i < log; ++i) {
+        positions = AddBlock(&m_network, positions, i * log);
+    }
+    m_network.Finish(positions);
+}
+
+int Periodic::Traverse(int input)
+{
+    if (input < 0 || input >= m_network.width()) {
+        throw std::invalid_argument("bad input");
+    }
+    return m_network.Traverse(input);
+}
+
+constexpr int DiffractingTree::kDefaultPrismWidth;
+constexpr int DiffractingTree::kDefaultSpins;
+
+DiffractingTree::DiffractingTree(int width, int prism_width, int spins)
+    : m_width(width),
+      m_depth(LayeredNetwork::Log2(width)),
+      m_prism_width(prism_width > 0 ? prism_width : 1),
+      m_spins(spins > 0 ? spins : 1),
+      m_nodes(new detail::Balancer[width - 1])
+{
+    size_t num_exchangers = 0;
+    for (int level = 0; level < m_depth; ++level) {
+        m_prism_offsets.push_back(num_exchangers);
+        num_exchangers += static_cast<size_t>(1 << level) * PrismWidth(level);
+    }
+    m_prisms.reset(new Exchanger[num_exchangers]);
+
+    // A token leaving node i by output b goes on to node 2i + 1 + b. At the last
+    // level, the outputs taken on the way are the bits of its output wire, the output
+    // at the root being the lowest.
+    for (int level = 0; level < m_depth; ++level) {
+        for (int i = (1 << level) - 1; i < (2 << level) - 1; ++i) {
+            for (int b = 0; b < 2; ++b) {
+                if (level + 1 < m_depth) {
+                    m_nodes[i].Connect(b, 2*i + 1 + b);
+                    continue;
+                }
+                int wire = b << level;
+                for (int node = i, l = level; l > 0; node = (node - 1) / 2, --l) {
+                    // Node n is the left child of its parent if n is odd.
+                    wire |= ((node - 1) % 2) << (l - 1);
+                }
+                m_nodes[i].Connect(b, wire);
+            }
+        }
+    }
+}
+
+int DiffractingTree::Traverse(int input)
+{
+    if (input < 0 || input >= m_width) {
+        throw std::invalid_argument("bad input");
+    }
+
+    int next = 0;
+    for (int level = 0; level < m_depth; ++level) {
+        int output = Diffract(next, level);
+        if (output < 0) {
+            output = m_nodes[next].Toggle();
+        }
+        next = m_nodes[next].next(output);
+    }
+    return next;
+}
+
+int DiffractingTree::Diffract(int node, int level)
+{
+    int prism_width = PrismWidth(level);
+    int index_in_level = node - ((1 << level) - 1);
+    Exchanger* exchanger = &m_prisms[m_prism_offsets[level] + static_cast<size_t>(index_in_level) * prism_width +
+                                     NextRandom() % prism_width];
+
+    // The token waiting goes left, and the one answering goes right.
+    int state = exchanger->state.load(std::memory_order_relaxed);
+    if (state == kWaiting) {
+        if (exchanger->state.compare_exchange_strong(state, kAnswered, std::memory_order_relaxed)) {
+            m_num_diffracted.fetch_add(2, std::memory_order_relaxed);
+            return 1;
+        }
+        return -1;
+    }
+    if (state != kEmpty ||
+        !exchanger->state.compare_exchange_strong(state, kWaiting, std::memory_order_relaxed)) {
+        return -1;
+    }
+    for (int i = 0; i < m_spins; ++i) {
+        if (exchanger->state.load(std::memory_order_relaxed) == kAnswered) {
+            exchanger->state.store(kEmpty, std::memory_order_relaxed);
+            return 0;
+        }
+    }
+    int expected = kWaiting;
+    if (exchanger->state.compare_exchange_strong(expected, kEmpty, std::memory_order_relaxed)) {
+        return -1;
+    }
+    // Answered just before the withdrawal.
+    exchanger->state.store(kEmpty, std::memory_order_relaxed);
+    return 0;
+}
+
+}  // namespace wsd
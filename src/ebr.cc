@@ -6,35 +6,127 @@
 
 #include "wsd/ebr.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace wsd {
 
-EbrManager::EbrManager()
+struct EbrManager::ThreadRecords {
+    // The most recently used first.
+    std::vector<CachedRecord> records;
+
+    ~ThreadRecords()
+    {
+        s_cached_record = CachedRecord{0, nullptr};
+        for (auto& r : records) {
+            RetireEbrRecord(r.record);
+        }
+    }
+};
+
+constexpr size_t EbrManager::kDefaultReclaimInterval;
+std::atomic<uint64_t> EbrManager::s_next_id{1};
+thread_local EbrManager::CachedRecord EbrManager::s_cached_record{0, nullptr};
+thread_local EbrManager::ThreadRecords EbrManager::s_thread_records;
+
+namespace {
+
+EbrManager::Options WithReclaimInterval(size_t reclaim_interval)
+{
+    EbrManager::Options options;
+    options.reclaim_interval = reclaim_interval;
+    return options;
+}
+
+}  // namespace
+
+EbrManager::EbrManager(size_t reclaim_interval) : EbrManager(WithReclaimInterval(reclaim_interval))
 {
 }
 
+EbrManager::EbrManager(const Options& options)
+    : m_id(s_next_id.fetch_add(1, std::memory_order_relaxed)),
+      m_reclaim_interval(options.reclaim_interval > 0 ? options.reclaim_interval : 1),
+      m_max_unreclaimed_bytes(options.max_unreclaimed_bytes),
+      m_background_reclaim_interval(options.background_reclaim_interval_ms)
+{
+    if (options.background_reclaim_interval_ms > 0) {
+        m_reclaimer = std::thread(&EbrManager::RunReclaimer, this);
+    }
+}
+
 EbrManager::~EbrManager()
 {
-    for (auto* p = m_head.load(std::memory_order_relaxed); p;) {
+    if (m_reclaimer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_reclaimer_mutex);
+            m_should_quit = true;
+        }
+        m_reclaimer_cond.notify_one();
+        m_reclaimer.join();
+    }
+
+    for (auto* p = m_head.load(std::memory_order_acquire); p;) {
         auto* q = p;
         p = p->next;
+        FreeList(q->pending_head);
+        q->pending_head = q->pending_tail = nullptr;
+        for (auto& bag : q->limbo_bags) {
+            FreeList(bag.head);
+            bag.head = nullptr;
+        }
+        // Threads using the record release it lazily.
+        q->is_orphaned.store(true, std::memory_order_release);
         q->DecRef();
     }
-    for (int i = 0; i < 3; ++i) {
-        FreeList(m_retire_list[i].load(std::memory_order_relaxed));
-    }
 }
 
 void EbrManager::EnterCriticalRegion()
 {
-    EbrRecord* p = GetEbrRecForCurrentThread();
-    p->active.store(true);
-    p->epoch.store(m_global_epoch.load(std::memory_order_acquire));
+    Enter();
 }
 
 void EbrManager::ExitCriticalRegion()
+{
+    Exit(GetEbrRecForCurrentThread());
+}
+
+EbrManager::EbrRecord* EbrManager::Enter()
 {
     EbrRecord* p = GetEbrRecForCurrentThread();
-    p->active.store(false);
+    if (p->nesting++ > 0) {
+        return p;
+    }
+    uint64_t epoch = m_global_epoch.load(std::memory_order_relaxed);
+    // A release store is as cheap as a relaxed one on x86, and lets the thread
+    // advancing the epoch synchronize with the previous critical region too.
+    p->state.store((epoch << 1) | 1, std::memory_order_release);
+    // Orders the announcement before the loads in the critical region.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return p;
+}
+
+// static
+void EbrManager::Exit(EbrRecord* p)
+{
+    assert(p->nesting > 0);
+    if (--p->nesting == 0) {
+        p->state.store(0, std::memory_order_release);
+        if (p->should_wait) {
+            p->manager->WaitForReclaim(p);
+        }
+    }
+}
+
+EbrManager::Stats EbrManager::GetStats() const
+{
+    Stats stats;
+    stats.num_unreclaimed = m_num_unreclaimed.load(std::memory_order_relaxed);
+    stats.unreclaimed_bytes = m_unreclaimed_bytes.load(std::memory_order_relaxed);
+    stats.epoch = m_global_epoch.load(std::memory_order_relaxed);
+    stats.num_failed_advances = m_num_failed_advances.load(std::memory_order_relaxed);
+    return stats;
 }
 
 EbrManager::EbrRecord* EbrManager::AllocateEbrRec()
@@ -43,10 +135,12 @@ EbrManager::EbrRecord* EbrManager::AllocateEbrRec()
         if (p->in_use.test_and_set(std::memory_order_acquire)) {
             continue;
         }
+        // Released by RetireEbrRecord() when the thread exits.
+        p->IncRef();
         return p;
     }
 
-    std::unique_ptr<EbrRecord> new_rec(new EbrRecord());
+    std::unique_ptr<EbrRecord> new_rec(new EbrRecord(this));
     new_rec->in_use.test_and_set(std::memory_order_relaxed);
     new_rec->IncRef();
     EbrRecord* old_head = nullptr;
@@ -60,41 +154,194 @@ EbrManager::EbrRecord* EbrManager::AllocateEbrRec()
 
 EbrManager::EbrRecord* EbrManager::GetEbrRecForCurrentThread()
 {
-    if (m_my_ebr_rec.get() == nullptr) {
-        m_my_ebr_rec.reset(AllocateEbrRec());
+    if (s_cached_record.manager_id == m_id) {
+        return s_cached_record.record;
+    }
+    return GetEbrRecSlow();
+}
+
+EbrManager::EbrRecord* EbrManager::GetEbrRecSlow()
+{
+    std::vector<CachedRecord>& records = s_thread_records.records;
+    auto it = std::find_if(records.begin(), records.end(),
+                           [this](const CachedRecord& r) { return r.manager_id == m_id; });
+    if (it == records.end()) {
+        records.reserve(records.size() + 1);
+        // Release the records of destroyed managers.
+        records.erase(std::remove_if(records.begin(), records.end(),
+                                     [](const CachedRecord& r) {
+                                         if (!r.record->is_orphaned.load(std::memory_order_acquire)) {
+                                             return false;
+                                         }
+                                         RetireEbrRecord(r.record);
+                                         return true;
+                                     }),
+                      records.end());
+        records.insert(records.begin(), CachedRecord{m_id, AllocateEbrRec()});
+    } else {
+        std::rotate(records.begin(), it, it + 1);
     }
-    return m_my_ebr_rec.get();
+    s_cached_record = records.front();
+    return s_cached_record.record;
 }
 
-void EbrManager::Scan()
+void EbrManager::Retire(EbrNode* node, size_t size)
 {
-    int global_epoch = m_global_epoch.load(std::memory_order_acquire);
+    EbrRecord* p = GetEbrRecForCurrentThread();
+    node->m_ebr_next = nullptr;
+    if (p->pending_tail) {
+        p->pending_tail->m_ebr_next = node;
+    } else {
+        p->pending_head = node;
+    }
+    p->pending_tail = node;
+    p->pending_bytes += size;
+
+    if (++p->num_pending >= m_reclaim_interval) {
+        TagPending(p);
+        TryAdvanceEpoch();
+        Reclaim(p);
+        // Otherwise waits when exiting the critical region.
+        if (p->should_wait && p->nesting == 0) {
+            WaitForReclaim(p);
+        }
+    }
+}
+
+void EbrManager::TagPending(EbrRecord* p)
+{
+    // Orders the unlinking of the pending nodes before reading the epoch.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t epoch = m_global_epoch.load(std::memory_order_acquire);
+    LimboBag& bag = p->limbo_bags[epoch % 3];
+    if (bag.epoch != epoch) {
+        // The bag holds nodes tagged epoch - 3 or earlier, which are safe to free.
+        FreeBag(&bag);
+        bag.epoch = epoch;
+    }
+    p->pending_tail->m_ebr_next = bag.head;
+    bag.head = p->pending_head;
+    bag.num_nodes += p->num_pending;
+    bag.num_bytes += p->pending_bytes;
+    m_num_unreclaimed.fetch_add(p->num_pending, std::memory_order_relaxed);
+    size_t bytes = m_unreclaimed_bytes.fetch_add(p->pending_bytes, std::memory_order_relaxed) + p->pending_bytes;
+    if (m_max_unreclaimed_bytes > 0 && bytes > m_max_unreclaimed_bytes) {
+        p->should_wait = true;
+    }
+    p->pending_head = p->pending_tail = nullptr;
+    p->num_pending = 0;
+    p->pending_bytes = 0;
+}
+
+bool EbrManager::TryAdvanceEpoch()
+{
+    uint64_t global_epoch = m_global_epoch.load(std::memory_order_relaxed);
+    // Pairs with the fence in EnterCriticalRegion().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
     for (auto* p = m_head.load(std::memory_order_acquire); p; p = p->next) {
-        if (p->active.load() && p->epoch != global_epoch) {
-            return;
+        uint64_t state = p->state.load(std::memory_order_acquire);
+        if ((state & 1) && (state >> 1) != global_epoch) {
+            m_num_failed_advances.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    if (!m_global_epoch.compare_exchange_strong(global_epoch, global_epoch + 1, std::memory_order_acq_rel,
+                                                std::memory_order_relaxed)) {
+        return false;
+    }
+    m_num_failed_advances.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void EbrManager::Reclaim(EbrRecord* p)
+{
+    uint64_t global_epoch = m_global_epoch.load(std::memory_order_acquire);
+    for (auto& bag : p->limbo_bags) {
+        if (bag.head && bag.epoch + 2 <= global_epoch) {
+            FreeBag(&bag);
+        }
+    }
+}
+
+void EbrManager::FreeBag(LimboBag* bag)
+{
+    FreeList(bag->head);
+    m_num_unreclaimed.fetch_sub(bag->num_nodes, std::memory_order_relaxed);
+    m_unreclaimed_bytes.fetch_sub(bag->num_bytes, std::memory_order_relaxed);
+    bag->head = nullptr;
+    bag->num_nodes = 0;
+    bag->num_bytes = 0;
+}
+
+// Retiring nodes beyond max_unreclaimed_bytes. Waits until the nodes retired by the
+// current thread are freed, since it can not free those of other running threads.
+void EbrManager::WaitForReclaim(EbrRecord* p)
+{
+    assert(p->nesting == 0);
+    m_reclaimer_cond.notify_one();
+    for (int i = 0;; ++i) {
+        if (p->pending_head) {
+            TagPending(p);
+        }
+        TryAdvanceEpoch();
+        Reclaim(p);
+        bool has_garbage = false;
+        for (auto& bag : p->limbo_bags) {
+            has_garbage = has_garbage || bag.head;
+        }
+        if (!has_garbage || m_unreclaimed_bytes.load(std::memory_order_relaxed) <= m_max_unreclaimed_bytes) {
+            break;
+        }
+        ReclaimAbandoned();
+        // Some thread is in a critical region, which may take long.
+        if (i < 16) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
     }
+    p->should_wait = false;
+}
 
-    int next_epoch = (global_epoch + 1) % 3;
-    FreeRetireList(next_epoch);
-    m_global_epoch.store(next_epoch, std::memory_order_release);
+// Frees the nodes retired by threads which have exited, which are otherwise freed
+// only when other threads reuse their records.
+void EbrManager::ReclaimAbandoned()
+{
+    for (auto* p = m_head.load(std::memory_order_acquire); p; p = p->next) {
+        if (p->in_use.test_and_set(std::memory_order_acquire)) {
+            continue;
+        }
+        if (p->pending_head) {
+            TagPending(p);
+            p->should_wait = false;
+        }
+        Reclaim(p);
+        p->in_use.clear(std::memory_order_release);
+    }
 }
 
-void EbrManager::FreeRetireList(int epoch)
+void EbrManager::RunReclaimer()
 {
-    NodeToRetire* head = m_retire_list[epoch].load(std::memory_order_relaxed);
-    while (!m_retire_list[epoch].compare_exchange_weak(head, nullptr, std::memory_order_release,
-                                                       std::memory_order_relaxed))
-        ;
-    FreeList(head);
+    std::unique_lock<std::mutex> lock(m_reclaimer_mutex);
+    while (!m_should_quit) {
+        m_reclaimer_cond.wait_for(lock, m_background_reclaim_interval);
+        if (m_should_quit) {
+            break;
+        }
+        lock.unlock();
+        TryAdvanceEpoch();
+        ReclaimAbandoned();
+        lock.lock();
+    }
 }
 
-void EbrManager::FreeList(NodeToRetire* head)
+// static
+void EbrManager::FreeList(EbrNode* head)
 {
     for (auto* p = head; p;) {
         auto* q = p;
-        p = p->next;
-        delete q;
+        p = p->m_ebr_next;
+        q->m_ebr_deleter(q);
     }
 }
 
@@ -6,51 +6,101 @@
 
 #include "wsd/hazard_pointer.h"
 
+#include <algorithm>
 #include <exception>
-#include <unordered_set>
+#include <vector>
 
 using namespace std;
 
 namespace wsd {
 
-HazardManager::HazardManager(int max_hp) : m_max_hp(max_hp)
+struct HazardManager::ThreadRecords {
+    // The most recently used first.
+    std::vector<CachedRecord> records;
+
+    ~ThreadRecords()
+    {
+        s_cached_record = CachedRecord{0, nullptr};
+        for (auto& r : records) {
+            RetireHpRec(r.record);
+        }
+    }
+};
+
+HazardManager::HazardManager(int num_slots) : HazardManager(num_slots, Options())
+{
+}
+
+std::atomic<uint64_t> HazardManager::s_next_id{1};
+thread_local HazardManager::CachedRecord HazardManager::s_cached_record{0, nullptr};
+thread_local HazardManager::ThreadRecords HazardManager::s_thread_records;
+
+HazardManager::HazardManager(int num_slots, const Options& options)
+    : m_id(s_next_id.fetch_add(1, std::memory_order_relaxed)),
+      m_initial_slots(num_slots > 0 ? num_slots : 1),
+      m_max_unreclaimed_bytes(options.max_unreclaimed_bytes),
+      m_background_reclaim_interval(options.background_reclaim_interval_ms)
 {
+    // So that readers skip the full fence from the start.
+    PrepareAsymmetricFences();
+    if (options.background_reclaim_interval_ms > 0) {
+        m_reclaimer = std::thread(&HazardManager::RunReclaimer, this);
+    }
 }
 
 HazardManager::~HazardManager()
 {
+    if (m_reclaimer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_reclaimer_mutex);
+            m_should_quit = true;
+        }
+        m_reclaimer_cond.notify_one();
+        m_reclaimer.join();
+    }
+
     // The hazard pointer list should contain no hazard pointers now. Decrement references to all
     // hazard pointers.
     for (auto* p = m_head.load(std::memory_order_acquire); p;) {
         auto* q = p;
         p = p->next;
+        // Threads using the record release it lazily.
+        q->is_orphaned.store(true, std::memory_order_release);
         q->DecRef();
     }
 }
 
+HazardManager::Stats HazardManager::GetStats() const
+{
+    Stats stats;
+    stats.num_unreclaimed = m_num_unreclaimed.load(std::memory_order_relaxed);
+    stats.unreclaimed_bytes = m_unreclaimed_bytes.load(std::memory_order_relaxed);
+    stats.num_live_slots = CountLiveSlots();
+    return stats;
+}
+
 int HazardManager::TEST_GetNumberOfHp() const
 {
     int hp_count = 0;
     for (auto* p = m_head.load(std::memory_order_acquire); p; p = p->next) {
-        for (int i = 0; i < m_max_hp; ++i) {
-            if (p->nodes[i]) {
+        p->ForEachSlot([&hp_count](const std::atomic<void*>& slot) {
+            if (slot.load(std::memory_order_relaxed)) {
                 ++hp_count;
             }
-        }
+        });
     }
     return hp_count;
 }
 
 bool HazardManager::TEST_HpListContains(void* p) const
 {
+    bool found = false;
     for (auto* q = m_head.load(std::memory_order_acquire); q; q = q->next) {
-        for (int i = 0; i < q->num_of_nodes; ++i) {
-            if (q->nodes[i] == p) {
-                return true;
-            }
-        }
+        q->ForEachSlot([p, &found](const std::atomic<void*>& slot) {
+            found = found || slot.load(std::memory_order_relaxed) == p;
+        });
     }
-    return false;
+    return found;
 }
 
 bool HazardManager::TEST_RetireListContains(void* p) const
@@ -67,9 +117,10 @@ bool HazardManager::TEST_RetireListContains(void* p) const
 
 int HazardManager::TEST_GetRetireListLenOfCurrentThread() const
 {
-    auto* hp_rec = m_my_hp_rec.get();
-    if (hp_rec) {
-        return hp_rec->retire_list.size();
+    for (const auto& r : s_thread_records.records) {
+        if (r.manager_id == m_id) {
+            return r.record->retire_list.size();
+        }
     }
     return 0;
 }
@@ -80,102 +131,213 @@ HazardManager::HPRecType* HazardManager::AllocateHpRec()
         if (p->active.test_and_set(std::memory_order_acquire)) {
             continue;
         }
-        // locked.
+        // locked. Released by RetireHpRec() when the thread exits.
+        p->IncRef();
+        p->num_live_slots.store(p->num_slots, std::memory_order_relaxed);
+        p->scan_threshold = 2 * CountLiveSlots();
         return p;
     }
 
-    std::unique_ptr<HPRecType> new_hp(new HPRecType(m_max_hp));
+    std::unique_ptr<HPRecType> new_hp(new HPRecType(m_initial_slots));
     new_hp->active.test_and_set(std::memory_order_relaxed);
     new_hp->IncRef();
+    new_hp->num_live_slots.store(new_hp->num_slots, std::memory_order_relaxed);
     new_hp->next = m_head.load(std::memory_order_relaxed);
     while (!m_head.compare_exchange_weak(new_hp->next, new_hp.get(), std::memory_order_release,
                                          std::memory_order_relaxed))
         ;
-    m_len.fetch_add(m_max_hp, std::memory_order_relaxed);
+    new_hp->scan_threshold = 2 * CountLiveSlots();
     return new_hp.release();
 }
 
+size_t HazardManager::CountLiveSlots() const
+{
+    size_t num_live_slots = 0;
+    for (auto* p = m_head.load(std::memory_order_acquire); p; p = p->next) {
+        num_live_slots += p->num_live_slots.load(std::memory_order_relaxed);
+    }
+    return num_live_slots;
+}
+
+std::atomic<void*>* HazardManager::HPRecType::AcquireSlot()
+{
+    if (free_slots.empty()) {
+        // Doubles the slots, which are rarely released by threads traversing long lists.
+        std::unique_ptr<SlotBlock> block(new SlotBlock(num_slots));
+        free_slots.reserve(num_slots + block->size);
+        for (size_t i = block->size; i > 0; --i) {
+            free_slots.push_back(&block->slots[i - 1]);
+        }
+        num_slots += block->size;
+        num_live_slots.store(num_slots, std::memory_order_relaxed);
+        // Publishes the initialized slots to scanning threads.
+        last_block->next.store(block.get(), std::memory_order_release);
+        last_block = block.release();
+    }
+    std::atomic<void*>* slot = free_slots.back();
+    free_slots.pop_back();
+    return slot;
+}
+
 HazardManager::HPRecType* HazardManager::GetHpRecForCurrentThread()
 {
-    if (m_my_hp_rec.get() == nullptr) {
-        m_my_hp_rec.reset(AllocateHpRec());
+    if (s_cached_record.manager_id == m_id) {
+        return s_cached_record.record;
+    }
+    return GetHpRecSlow();
+}
+
+HazardManager::HPRecType* HazardManager::GetHpRecSlow()
+{
+    // Keyed by the id rather than the address of the manager, since a manager may be
+    // allocated where a destroyed one was.
+    std::vector<CachedRecord>& records = s_thread_records.records;
+    auto it = std::find_if(records.begin(), records.end(),
+                           [this](const CachedRecord& r) { return r.manager_id == m_id; });
+    if (it == records.end()) {
+        records.reserve(records.size() + 1);
+        // Release the records of destroyed managers.
+        records.erase(std::remove_if(records.begin(), records.end(),
+                                     [](const CachedRecord& r) {
+                                         if (!r.record->is_orphaned.load(std::memory_order_acquire)) {
+                                             return false;
+                                         }
+                                         RetireHpRec(r.record);
+                                         return true;
+                                     }),
+                      records.end());
+        records.insert(records.begin(), CachedRecord{m_id, AllocateHpRec()});
+    } else {
+        std::rotate(records.begin(), it, it + 1);
     }
-    return m_my_hp_rec.get();
+    s_cached_record = records.front();
+    return s_cached_record.record;
 }
 
 // static
 void HazardManager::RetireHpRec(HazardManager::HPRecType* p)
 {
-    for (int i = 0; i < p->num_of_nodes; ++i) {
-        p->nodes[i] = nullptr;
+    // Called by the thread owning the record, when it exits or finds the manager destroyed.
+    if (s_cached_record.record == p) {
+        s_cached_record = CachedRecord{0, nullptr};
     }
+    p->ForEachSlot([](std::atomic<void*>& slot) { slot.store(nullptr, std::memory_order_relaxed); });
+    p->num_live_slots.store(0, std::memory_order_relaxed);
     p->active.clear(std::memory_order_release);
     p->DecRef();
 }
 
-void HazardManager::Scan()
+void HazardManager::Scan(HPRecType* hp_rec)
 {
-    std::unordered_set<void*> plist;
-    auto* hp = m_head.load(std::memory_order_acquire);
-    while (hp != nullptr) {
-        for (int i = 0; i < m_max_hp; ++i) {
-            auto* p = hp->nodes[i];
+    std::vector<void*>& plist = hp_rec->hp_snapshot;
+    plist.clear();
+    // Pairs with the light fence of readers: either the reader sees the unlinking of
+    // the retired nodes, or this sees its hazard pointer.
+    AsymmetricHeavyFence();
+    size_t num_live_slots = 0;
+    for (auto* hp = m_head.load(std::memory_order_acquire); hp; hp = hp->next) {
+        num_live_slots += hp->num_live_slots.load(std::memory_order_relaxed);
+        hp->ForEachSlot([&plist](const std::atomic<void*>& slot) {
+            // Synchronizes with Release(), so that the reader is done with the node.
+            auto* p = slot.load(std::memory_order_acquire);
             if (p) {
-                plist.insert(p);
+                plist.push_back(p);
             }
-        }
-        hp = hp->next;
+        });
     }
+    std::sort(plist.begin(), plist.end());
+    // At least half of the nodes retired until the next scan are not protected now,
+    // however many hazard pointers threads have used, or threads have exited.
+    hp_rec->scan_threshold = 2 * num_live_slots;
 
-    HPRecType* hp_rec = GetHpRecForCurrentThread();
-    std::list<NodeToRetire> tmp_list;
-    tmp_list.swap(hp_rec->retire_list);
-    for (auto& n : tmp_list) {
-        if (plist.count(n.node) > 0) {
-            hp_rec->retire_list.push_back(std::move(n));
+    // Keeps the protected nodes at the front of the retire list in place.
+    std::vector<NodeToRetire>& retire_list = hp_rec->retire_list;
+    size_t num_kept = 0;
+    size_t freed_bytes = 0;
+    for (size_t i = 0; i < retire_list.size(); ++i) {
+        const NodeToRetire& n = retire_list[i];
+        if (std::binary_search(plist.begin(), plist.end(), n.node)) {
+            retire_list[num_kept++] = n;
+        } else {
+            freed_bytes += n.size;
+            n.deleter(n.node);
         }
     }
+    size_t num_freed = retire_list.size() - num_kept;
+    retire_list.resize(num_kept);
+    // Counts the new nodes and the freed ones at once. The differences may wrap around,
+    // which unsigned arithmetic handles.
+    m_num_unreclaimed.fetch_add(hp_rec->num_uncounted - num_freed, std::memory_order_relaxed);
+    m_unreclaimed_bytes.fetch_add(hp_rec->uncounted_bytes - freed_bytes, std::memory_order_relaxed);
+    hp_rec->num_uncounted = 0;
+    hp_rec->uncounted_bytes = 0;
 }
 
-void HazardManager::HelpScan()
+void HazardManager::HelpScan(HPRecType* hp_rec)
 {
-    HPRecType* hp_rec = GetHpRecForCurrentThread();
     for (auto* p = m_head.load(std::memory_order_acquire); p; p = p->next) {
         if (p->active.test_and_set(std::memory_order_acquire)) {
             continue;
         }
-        hp_rec->retire_list.splice(hp_rec->retire_list.end(), p->retire_list);
-        if (hp_rec->retire_list.size() >= 2 * m_len.load(std::memory_order_relaxed)) {
-            Scan();
+        hp_rec->retire_list.insert(hp_rec->retire_list.end(), p->retire_list.begin(), p->retire_list.end());
+        p->retire_list.clear();
+        hp_rec->num_uncounted += p->num_uncounted;
+        hp_rec->uncounted_bytes += p->uncounted_bytes;
+        p->num_uncounted = 0;
+        p->uncounted_bytes = 0;
+        if (hp_rec->retire_list.size() >= hp_rec->scan_threshold) {
+            Scan(hp_rec);
         }
         p->active.clear(std::memory_order_release);
     }
 }
 
-HazardPointer::HazardPointer(HazardManager& mgr, int i)
+void HazardManager::RunReclaimer()
 {
-    HazardManager::HPRecType* hp_rec = mgr.GetHpRecForCurrentThread();
-    if (i >= mgr.m_max_hp) {
-        throw std::invalid_argument("input number bigger than number of hazard pointers");
+    HPRecType* hp_rec = GetHpRecForCurrentThread();
+    std::unique_lock<std::mutex> lock(m_reclaimer_mutex);
+    while (!m_should_quit) {
+        m_reclaimer_cond.wait_for(lock, m_background_reclaim_interval);
+        if (m_should_quit) {
+            break;
+        }
+        lock.unlock();
+        // Adopts the nodes retired by exited threads.
+        HelpScan(hp_rec);
+        Scan(hp_rec);
+        lock.lock();
     }
-    m_hp = &hp_rec->nodes[i];
+}
+
+HazardPointer::HazardPointer(HazardManager& mgr)
+{
+    Init(mgr);
+}
+
+void HazardPointer::Init(HazardManager& mgr)
+{
+    m_hp_rec = mgr.GetHpRecForCurrentThread();
+    m_hp = m_hp_rec->AcquireSlot();
 }
 
 HazardPointer::~HazardPointer()
 {
-    Release();
+    // Null if HazardPointerArray failed to take all the hazard pointers.
+    if (m_hp) {
+        m_hp_rec->ReleaseSlot(m_hp);
+    }
 }
 
 void HazardPointer::Acquire(void* p)
 {
-    *m_hp = p;
+    m_hp->store(p, std::memory_order_relaxed);
     // Make the validation happens after this.
-    std::atomic_thread_fence(std::memory_order_seq_cst);
+    AsymmetricLightFence();
 }
 
 void HazardPointer::Release()
 {
-    *m_hp = nullptr;
+    m_hp->store(nullptr, std::memory_order_release);
 }
 
 }  // namespace wsd
@@ -0,0 +1,61 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "wsd/detail/layered_network.h"
+
+#include <stdexcept>
+
+namespace wsd {
+namespace detail {
+
+int LayeredNetwork::Log2(int width)
+{
+    if (width < 2 || (width & (width - 1)) != 0) {
+        throw std::invalid_argument("width should be a power of two");
+    }
+    int n = 0;
+    while ((1 << n) < width) {
+        ++n;
+    }
+    return n;
+}
+
+LayeredNetwork::LayeredNetwork(int width, int depth)
+    : m_width(width),
+      m_depth(depth),
+      m_balancers(new Balancer[depth * (width / 2)]),
+      m_entries(new int[width]),
+      m_sizes(depth, 0)
+{
+}
+
+std::pair<int, int> LayeredNetwork::Place(int layer, int a, int b)
+{
+    int k = m_sizes[layer]++;
+    int index = layer * (m_width / 2) + k;
+    Connect(layer, a, index);
+    Connect(layer, b, index);
+    return std::make_pair(2 * k, 2 * k + 1);
+}
+
+void LayeredNetwork::Finish(const std::vector<int>& positions)
+{
+    for (size_t i = 0; i < positions.size(); ++i) {
+        Connect(m_depth, positions[i], static_cast<int>(i));
+    }
+}
+
+void LayeredNetwork::Connect(int layer, int position, int next)
+{
+    if (layer == 0) {
+        m_entries[position] = next;
+    } else {
+        m_balancers[(layer - 1) * (m_width / 2) + position / 2].Connect(position % 2, next);
+    }
+}
+
+}  // namespace detail
+}  // namespace wsd
@@ -0,0 +1,84 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "wsd/detail/thread_slots.h"
+
+#include <algorithm>
+
+namespace wsd {
+namespace detail {
+
+std::atomic<uint64_t> ThreadSlots::s_next_id{1};
+thread_local ThreadSlots::CachedSlot ThreadSlots::s_cached_slot{0, nullptr};
+thread_local ThreadSlots::ThreadRecords ThreadSlots::s_thread_records;
+
+ThreadSlots::Slot* ThreadSlots::Table::Acquire()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t i = std::find(held.begin(), held.end(), false) - held.begin();
+    if (i == slots.size()) {
+        slots.emplace_back(new Slot(static_cast<int>(i)));
+        held.push_back(true);
+    } else {
+        held[i] = true;
+    }
+    if (static_cast<int>(i) >= limit.load(std::memory_order_relaxed)) {
+        limit.store(static_cast<int>(i) + 1, std::memory_order_relaxed);
+    }
+    return slots[i].get();
+}
+
+void ThreadSlots::Table::Release(Slot* slot)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    held[slot->index] = false;
+    int n = limit.load(std::memory_order_relaxed);
+    while (n > 0 && !held[n - 1]) {
+        --n;
+    }
+    limit.store(n, std::memory_order_relaxed);
+}
+
+ThreadSlots::ThreadRecords::~ThreadRecords()
+{
+    s_cached_slot = CachedSlot{0, nullptr};
+    for (auto& s : slots) {
+        s.table->Release(s.slot);
+    }
+}
+
+ThreadSlots::ThreadSlots() : m_id(s_next_id.fetch_add(1, std::memory_order_relaxed)), m_table(new Table())
+{
+}
+
+ThreadSlots::~ThreadSlots()
+{
+    // Threads holding slots release them lazily.
+    m_table->is_orphaned.store(true, std::memory_order_release);
+}
+
+ThreadSlots::Slot* ThreadSlots::GetSlow()
+{
+    std::vector<HeldSlot>& slots = s_thread_records.slots;
+    auto it = std::find_if(slots.begin(), slots.end(), [this](const HeldSlot& s) { return s.owner_id == m_id; });
+    if (it == slots.end()) {
+        // Forget the slots of destroyed owners.
+        slots.erase(std::remove_if(slots.begin(), slots.end(),
+                                   [](const HeldSlot& s) {
+                                       return s.table->is_orphaned.load(std::memory_order_acquire);
+                                   }),
+                    slots.end());
+        slots.reserve(slots.size() + 1);
+        slots.insert(slots.begin(), HeldSlot{m_id, m_table->Acquire(), m_table});
+    } else {
+        std::rotate(slots.begin(), it, it + 1);
+    }
+    s_cached_slot = CachedSlot{m_id, slots.front().slot};
+    return s_cached_slot.slot;
+}
+
+}  // namespace detail
+}  // namespace wsd
@@ -6,9 +6,13 @@
 
 #include "wsd/bitonic.h"
 #include "wsd/benchmark.h"
+#include "wsd/counting_network.h"
+#include "wsd/ms_queue.h"
 #include "wsd/util.h"
+#include "wsd/work_distributor.h"
 #include <cstdlib>
 #include <atomic>
+#include <memory>
 
 using namespace std;
 
@@ -17,12 +21,14 @@ public:
     BitonicBench()
         : m_width(1 << 5),
           m_bitonic(m_width),
+          m_counter(m_width),
           m_int(0)
     {}
     
 protected:
     const int m_width;
     wsd::Bitonic m_bitonic;
+    wsd::BitonicCounter m_counter;
     std::atomic<int> m_int;
 };
 
@@ -37,3 +43,87 @@ TEST_CASE(BitonicBench, atomic)
     ++m_int;
     return 0;
 }
+
+TEST_CASE(BitonicBench, counter)
+{
+    return static_cast<int>(m_counter.GetAndIncrement());
+}
+
+// The counting networks through their common interface. Run each case with
+// --concurrency from 1 to 64 to pick one for a workload.
+class CountingNetworkBench : public wsd::benchmark::Test {
+public:
+    CountingNetworkBench()
+        : m_bitonic(kWidth),
+          m_periodic(kWidth),
+          m_diffracting_tree(kWidth)
+    {}
+
+protected:
+    static const int kWidth = 1 << 5;
+
+    static int Traverse(wsd::CountingNetwork* network)
+    {
+        return network->Traverse(wsd::ThreadId() % kWidth);
+    }
+
+    wsd::Bitonic m_bitonic;
+    wsd::Periodic m_periodic;
+    wsd::DiffractingTree m_diffracting_tree;
+};
+
+TEST_CASE(CountingNetworkBench, bitonic)
+{
+    return Traverse(&m_bitonic);
+}
+
+TEST_CASE(CountingNetworkBench, periodic)
+{
+    return Traverse(&m_periodic);
+}
+
+TEST_CASE(CountingNetworkBench, diffracting_tree)
+{
+    return Traverse(&m_diffracting_tree);
+}
+
+// Each operation submits a task and takes one back, from the queue of the thread
+// first, so the queues stay short. Tasks are spread by a bitonic network, or by a
+// round-robin fetch_add().
+class DistributorBench : public wsd::benchmark::Test {
+public:
+    DistributorBench()
+        : m_distributor(kQueues),
+          m_queues(new wsd::MsQueue<int>[kQueues]),
+          m_next(0)
+    {}
+
+protected:
+    static const int kQueues = 1 << 5;
+
+    template <typename TryTake>
+    static int TakeAny(TryTake try_take)
+    {
+        int task = 0;
+        int first = wsd::ThreadId();
+        for (int i = 0; i < kQueues && !try_take((first + i) % kQueues, &task); ++i) {
+        }
+        return task;
+    }
+
+    wsd::WorkDistributor<int> m_distributor;
+    std::unique_ptr<wsd::MsQueue<int>[]> m_queues;
+    std::atomic<unsigned> m_next;
+};
+
+TEST_CASE(DistributorBench, bitonic)
+{
+    m_distributor.Submit(1);
+    return TakeAny([this](int queue, int* task) { return m_distributor.TryTake(queue, task); });
+}
+
+TEST_CASE(DistributorBench, fetch_add)
+{
+    m_queues[m_next.fetch_add(1, std::memory_order_relaxed) % kQueues].Push(1);
+    return TakeAny([this](int queue, int* task) { return m_queues[queue].TryPop(task); });
+}
@@ -12,6 +12,7 @@
 #include <cstdlib>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <stdexcept>
 #include <thread>
 
 using namespace std;
@@ -38,7 +39,8 @@ void CheckResult(const vector<int>& result)
         
 TEST(Bitonic, basic)
 {
-    for (int i = 1; i < 20; ++i) {
+    // Balancers take a cache line each, so wider networks take gigabytes.
+    for (int i = 1; i < 16; ++i) {
         int width = (1 << i);
         wsd::Bitonic bitonic(width);
         vector<int> result;
@@ -49,6 +51,25 @@ TEST(Bitonic, basic)
     }
 }
 
+TEST(Bitonic, sequential)
+{
+    for (int i = 1; i < 12; ++i) {
+        int width = (1 << i);
+        wsd::Bitonic bitonic(width);
+        EXPECT_EQ(i * (i + 1) / 2, bitonic.depth());
+        // Every state is quiescent, so the k-th token leaves on wire k % width.
+        for (int k = 0; k < 3*width; ++k) {
+            ASSERT_EQ(k % width, bitonic.Traverse(rand() % width));
+        }
+    }
+}
+
+TEST(Bitonic, bad_width)
+{
+    EXPECT_THROW(wsd::Bitonic(0), std::invalid_argument);
+    EXPECT_THROW(wsd::Bitonic(6), std::invalid_argument);
+}
+
 TEST(Bitonic, multithread)
 {
     const int width = (1 << 10);
@@ -73,3 +94,40 @@ TEST(Bitonic, multithread)
     }
     CheckResult(result);
 }
+
+TEST(BitonicCounter, sequential)
+{
+    wsd::BitonicCounter counter(8);
+    for (uint64_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(i, counter.GetAndIncrement());
+    }
+}
+
+TEST(BitonicCounter, multithread)
+{
+    const int kThreads = 16;
+    const int kIncrements = 10000;
+    wsd::BitonicCounter counter(8);
+    vector<thread> threads;
+    vector<vector<uint64_t>> values_per_thread(kThreads);
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back(
+                [&, i] {
+                    for (int j = 0; j < kIncrements; ++j) {
+                        values_per_thread[i].push_back(counter.GetAndIncrement());
+                    }
+                });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    vector<uint64_t> values;
+    for (const auto& v : values_per_thread) {
+        values.insert(values.end(), v.begin(), v.end());
+    }
+    // Quiescent now, so the values are 0 to n - 1.
+    sort(values.begin(), values.end());
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(i, values[i]);
+    }
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "wsd/benchmark.h"
+#include "wsd/bind.h"
+#include "wsd/callback.h"
+
+using namespace std;
+
+namespace {
+
+int Add(int a, int b)
+{
+    return a + b;
+}
+
+class Adder {
+public:
+    int Add(int a, int b)
+    {
+        return a + b + m_c;
+    }
+
+private:
+    int m_c = 1;
+};
+
+}  // namespace
+
+class CallbackBench : public wsd::benchmark::Test {
+public:
+    CallbackBench()
+        : m_adder(new Adder()),
+          m_callback(wsd::bind(&Add, 1)),
+          m_function(std::bind(&Add, 1, std::placeholders::_1))
+    {
+    }
+
+protected:
+    shared_ptr<Adder> m_adder;
+    wsd::Callback<int(int)> m_callback;
+    std::function<int(int)> m_function;
+};
+
+// Bound states stored inline: a bare function with an int, and a method with a
+// shared object.
+TEST_CASE(CallbackBench, bind_function)
+{
+    wsd::Callback<int(int)> cb = wsd::bind(&Add, 1);
+    return cb(2) == 3 ? 0 : 1;
+}
+
+TEST_CASE(CallbackBench, std_function_bind_function)
+{
+    std::function<int(int)> f = std::bind(&Add, 1, std::placeholders::_1);
+    return f(2) == 3 ? 0 : 1;
+}
+
+TEST_CASE(CallbackBench, bind_shared_method)
+{
+    wsd::Callback<int(int)> cb = wsd::bind(&Adder::Add, wsd::shared(m_adder), 1);
+    return cb(2) == 4 ? 0 : 1;
+}
+
+TEST_CASE(CallbackBench, std_function_shared_method)
+{
+    shared_ptr<Adder> adder = m_adder;
+    std::function<int(int)> f = [adder](int b) { return adder->Add(1, b); };
+    return f(2) == 4 ? 0 : 1;
+}
+
+// Bound states stored on the heap.
+TEST_CASE(CallbackBench, bind_owned_method)
+{
+    wsd::Callback<int(int)> cb = wsd::bind(&Adder::Add, wsd::owned(new Adder()), 1);
+    return cb(2) == 4 ? 0 : 1;
+}
+
+TEST_CASE(CallbackBench, std_function_owned_method)
+{
+    shared_ptr<Adder> adder(new Adder());
+    std::function<int(int)> f = [adder](int b) { return adder->Add(1, b); };
+    return f(2) == 4 ? 0 : 1;
+}
+
+// Copies, like the ones made when callbacks are registered on futures.
+TEST_CASE(CallbackBench, copy)
+{
+    wsd::Callback<int(int)> cb = m_callback;
+    return cb(2) == 3 ? 0 : 1;
+}
+
+TEST_CASE(CallbackBench, std_function_copy)
+{
+    std::function<int(int)> f = m_function;
+    return f(2) == 3 ? 0 : 1;
+}
+
+TEST_CASE(CallbackBench, run)
+{
+    return m_callback(2) == 3 ? 0 : 1;
+}
+
+TEST_CASE(CallbackBench, std_function_run)
+{
+    return m_function(2) == 3 ? 0 : 1;
+}
@@ -129,6 +129,72 @@ TEST(callback, shared)
     EXPECT_EQ(5, p->getX());
 }
 
+std::string foo_string(const std::string& s)
+{
+    return s;
+}
+
+struct Counted {
+    explicit Counted(int* count) : m_count(count)
+    {
+    }
+    ~Counted()
+    {
+        ++*m_count;
+    }
+    int get()
+    {
+        return 7;
+    }
+    int* m_count;
+};
+
+TEST(callback, small_state_is_inline)
+{
+    std::shared_ptr<X> p(new X(5));
+
+    // The next memory allocation throws.
+    g_throw_counter = 0;
+    try {
+        wsd::Callback<int()> cb1 = wsd::bind(&foo_int, 10);
+        wsd::Callback<int()> cb2 = wsd::bind(&X::getX, wsd::shared(p));
+        wsd::Callback<int()> cb3 = cb1;
+        wsd::Callback<int()> cb4(std::move(cb2));
+        g_throw_counter = -1;
+        EXPECT_EQ(10, cb3());
+        EXPECT_EQ(5, cb4());
+        EXPECT_FALSE(cb2);
+    } catch (...) {
+        g_throw_counter = -1;
+        FAIL() << "small bound states should not allocate memory";
+    }
+}
+
+TEST(callback, copy_and_move)
+{
+    int destroyed = 0;
+    {
+        // Owned objects are kept on the heap and shared by copies.
+        wsd::Callback<int()> cb1 = wsd::bind(&Counted::get, wsd::owned(new Counted(&destroyed)));
+        wsd::Callback<int()> cb2 = cb1;
+        wsd::Callback<int()> cb3;
+        cb3 = std::move(cb1);
+        EXPECT_FALSE(cb1);
+        EXPECT_EQ(7, cb2());
+        EXPECT_EQ(7, cb3());
+        cb2 = wsd::Callback<int()>();
+        EXPECT_EQ(0, destroyed);
+    }
+    EXPECT_EQ(1, destroyed);
+
+    std::string s(100, 'x');
+    wsd::Callback<std::string()> cb4 = wsd::bind(&foo_string, s);
+    wsd::Callback<std::string()> cb5 = cb4;
+    cb4 = cb5;
+    EXPECT_EQ(s, cb4());
+    EXPECT_EQ(s, cb5());
+}
+
 int foo0()
 {
     return 3;
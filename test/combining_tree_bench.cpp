@@ -0,0 +1,34 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+// Compare the cases with increasing --concurrency to see where combining starts to
+// beat a contended fetch_add.
+
+#include <atomic>
+
+#include "wsd/benchmark.h"
+#include "wsd/combining_tree.h"
+
+class CombiningTreeBench : public wsd::benchmark::Test {
+public:
+    // Grows with --concurrency.
+    CombiningTreeBench() : m_tree(2)
+    {
+    }
+
+protected:
+    wsd::CombiningTree<int> m_tree;
+    std::atomic<int> m_counter{0};
+};
+
+TEST_CASE(CombiningTreeBench, combining)
+{
+    return m_tree.GetAndIncrement();
+}
+
+TEST_CASE(CombiningTreeBench, fetch_add)
+{
+    return m_counter.fetch_add(1, std::memory_order_relaxed);
+}
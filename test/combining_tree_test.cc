@@ -4,51 +4,144 @@
 // Author: wbbtiger@gmail.com
 //
 
-#include <time.h>
 #include "wsd/combining_tree.h"
-#include <iostream>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <thread>
 #include <vector>
-#include <mutex>
 
-using namespace std;
+#include "gtest/gtest.h"
+
+namespace {
 
-int main(int argc, char** argv)
+const int kThreads = 16;
+
+template <typename F>
+void RunThreads(F f)
 {
-    const int kThreads = 100;
-    wsd::CombiningTree tree(kThreads*2);
-    vector<thread> threads;
-    int start_time = time(nullptr);
+    std::vector<std::thread> threads;
     for (int i = 0; i < kThreads; ++i) {
-        threads.emplace_back([&] {
-            for (int j = 0; j < 1000000; ++j) {
-                tree.GetAndIncrement();
-            }
-        });
+        threads.emplace_back(f, i);
     }
     for (auto& t : threads) {
         t.join();
     }
-    int end_time = time(nullptr);
-    cout << "latency=" << (end_time - start_time) << endl;
-    cout << "count=" << tree.Get() << endl;
-
-    mutex mu;
-    int counter = 0;
-    threads.clear();
-    start_time = time(nullptr);
+}
+
+struct Max {
+    uint64_t operator()(uint64_t a, uint64_t b) const
+    {
+        return std::max(a, b);
+    }
+};
+
+}  // namespace
+
+TEST(CombiningTree, increment)
+{
+    wsd::CombiningTree<int> tree(kThreads);
+    RunThreads([&](int) {
+        for (int j = 0; j < 10000; ++j) {
+            tree.GetAndIncrement();
+        }
+    });
+    EXPECT_EQ(kThreads * 10000, tree.Get());
+}
+
+TEST(CombiningTree, add)
+{
+    wsd::CombiningTree<uint64_t> tree(kThreads, 1ull << 40);
+    const int kRanges = 1000;
+    std::vector<std::vector<uint64_t>> ranges(kThreads);
+    RunThreads([&](int i) {
+        for (int j = 0; j < kRanges; ++j) {
+            ranges[i].push_back(tree.GetAndAdd(i + 1));
+        }
+    });
+    // The ranges [start, start + i + 1) allocated tile the sequence.
+    std::vector<std::pair<uint64_t, uint64_t>> all;
     for (int i = 0; i < kThreads; ++i) {
-        threads.emplace_back([&] {
-            for (int j = 0; j < 1000000; ++j) {
-                unique_lock<mutex> lock(mu);
-                ++counter;
-            }
-        });
+        for (uint64_t start : ranges[i]) {
+            all.emplace_back(start, start + i + 1);
+        }
     }
-    for (auto& t : threads) {
-        t.join();
+    std::sort(all.begin(), all.end());
+    uint64_t next = 1ull << 40;
+    for (const auto& r : all) {
+        ASSERT_EQ(next, r.first);
+        next = r.second;
+    }
+    EXPECT_EQ(next, tree.Get());
+}
+
+TEST(CombiningTree, max)
+{
+    wsd::CombiningTree<uint64_t, Max> tree(kThreads);
+    RunThreads([&](int i) {
+        uint64_t last = 0;
+        for (uint64_t j = 0; j < 1000; ++j) {
+            uint64_t prior = tree.GetAndApply(j * kThreads + i);
+            // Values only grow.
+            ASSERT_GE(prior, last);
+            last = prior;
+        }
+    });
+    EXPECT_EQ(999u * kThreads + kThreads - 1, tree.Get());
+}
+
+TEST(CombiningTree, bit_or)
+{
+    wsd::CombiningTree<uint64_t, std::bit_or<uint64_t>> tree(kThreads);
+    RunThreads([&](int i) {
+        for (int j = 0; j < 1000; ++j) {
+            tree.GetAndApply(1ull << (i * 4 + j % 4));
+        }
+    });
+    EXPECT_EQ(~0ull, tree.Get());
+}
+
+// The tree grows when more threads use it than it has room for.
+TEST(CombiningTree, grow)
+{
+    wsd::CombiningTree<int> tree(2);
+    EXPECT_EQ(2, tree.capacity());
+    std::atomic<int> started{0};
+    std::atomic<int> finished{0};
+    RunThreads([&](int) {
+        // Threads get slots on their first operation, and hold them until they exit.
+        tree.GetAndIncrement();
+        ++started;
+        while (started.load() < kThreads) {
+            std::this_thread::yield();
+        }
+        for (int j = 1; j < 10000; ++j) {
+            tree.GetAndIncrement();
+        }
+        // Otherwise threads still running shrink the tree as others exit.
+        ++finished;
+        while (finished.load() < kThreads) {
+            std::this_thread::yield();
+        }
+    });
+    EXPECT_EQ(kThreads * 10000, tree.Get());
+    EXPECT_EQ(kThreads, tree.capacity());
+}
+
+// Short-lived threads give their slots back, so the tree shrinks once they are
+// gone, and does not grow with the number of threads ever started.
+TEST(CombiningTree, churn)
+{
+    wsd::CombiningTree<int> tree(2);
+    RunThreads([&](int) {
+        for (int j = 0; j < 1000; ++j) {
+            tree.GetAndIncrement();
+        }
+    });
+    for (int round = 0; round < 100; ++round) {
+        std::thread([&]() { tree.GetAndIncrement(); }).join();
     }
-    end_time = time(nullptr);
-    cout << "latency=" << (end_time - start_time) << endl;
-    return 0;
+    EXPECT_EQ(kThreads * 1000 + 100, tree.Get());
+    EXPECT_EQ(2, tree.capacity());
 }
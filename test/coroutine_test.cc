@@ -0,0 +1,183 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "coroutine.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Runs coroutines in a dedicated thread.
+class ThreadExecutor : public wsd::Executor {
+public:
+    ThreadExecutor() : m_should_quit(false), m_thread(&ThreadExecutor::run, this)
+    {
+    }
+
+    ~ThreadExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_should_quit = true;
+        }
+        m_cond.notify_one();
+        m_thread.join();
+    }
+
+    void execute(std::coroutine_handle<> handle) override
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_handles.push_back(handle);
+        }
+        m_cond.notify_one();
+    }
+
+    std::thread::id id() const
+    {
+        return m_thread.get_id();
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_should_quit || !m_handles.empty()) {
+            if (m_handles.empty()) {
+                m_cond.wait(lock);
+                continue;
+            }
+            std::coroutine_handle<> handle = m_handles.front();
+            m_handles.pop_front();
+            lock.unlock();
+            handle.resume();
+            lock.lock();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<std::coroutine_handle<>> m_handles;
+    bool m_should_quit;
+    std::thread m_thread;
+};
+
+wsd::Task<int> addOne(wsd::Future<int> future)
+{
+    int i = co_await future;
+    co_return i + 1;
+}
+
+wsd::Task<int> addTwo(wsd::Future<int> future)
+{
+    int i = co_await addOne(future);
+    co_return i + 1;
+}
+
+wsd::Task<void> throwError()
+{
+    throw std::runtime_error("error");
+    co_return;
+}
+
+wsd::Task<int> catchError()
+{
+    try {
+        co_await throwError();
+    } catch (const std::runtime_error&) {
+        co_return 1;
+    }
+    co_return 0;
+}
+
+wsd::Task<int> deepChain(int n)
+{
+    if (n == 0) co_return 0;
+    co_return 1 + co_await deepChain(n - 1);
+}
+
+wsd::Task<std::thread::id> threadAfterAwait(wsd::Future<int> future)
+{
+    co_await future;
+    co_return std::this_thread::get_id();
+}
+
+wsd::Task<std::thread::id> threadAfterSwitch(ThreadExecutor& executor)
+{
+    co_await wsd::switchTo(executor);
+    co_return std::this_thread::get_id();
+}
+
+}  // namespace
+
+TEST(coroutine, lazy_task)
+{
+    wsd::Promise<int> p;
+    wsd::Task<int> task = addOne(p.getFuture());
+    p.setValue(1);
+    wsd::Future<int> f = wsd::toFuture(std::move(task));
+    EXPECT_EQ(2, f.get());
+}
+
+TEST(coroutine, await_future_and_task)
+{
+    wsd::Promise<int> p;
+    wsd::Future<int> f = wsd::toFuture(addTwo(p.getFuture()));
+    EXPECT_FALSE(f.isDone());
+    p.setValue(1);
+    EXPECT_EQ(3, f.get());
+}
+
+TEST(coroutine, exception)
+{
+    EXPECT_THROW(wsd::toFuture(throwError()).get(), std::runtime_error);
+    EXPECT_EQ(1, wsd::toFuture(catchError()).get());
+
+    wsd::Promise<int> p;
+    wsd::Future<int> f = wsd::toFuture(addOne(p.getFuture()));
+    p.setException(std::make_exception_ptr(std::runtime_error("")));
+    EXPECT_THROW(f.get(), std::runtime_error);
+}
+
+TEST(coroutine, symmetric_transfer)
+{
+    // Each task resumes its callee and then its caller by symmetric transfer.
+    EXPECT_EQ(10000, wsd::toFuture(deepChain(10000)).get());
+}
+
+TEST(coroutine, executor)
+{
+    ThreadExecutor executor;
+    wsd::Promise<int> p;
+    wsd::Future<std::thread::id> f = wsd::toFuture(threadAfterAwait(p.getFuture()), &executor);
+    p.setValue(1);
+    EXPECT_EQ(executor.id(), f.get());
+
+    ThreadExecutor executor2;
+    EXPECT_EQ(executor2.id(), wsd::toFuture(threadAfterSwitch(executor2), &executor).get());
+}
+
+TEST(coroutine, many_threads)
+{
+    ThreadExecutor executor;
+    std::vector<wsd::Promise<int>> promises(1000);
+    std::vector<wsd::Future<int>> futures;
+    for (size_t i = 0; i < promises.size(); i++) {
+        futures.push_back(wsd::toFuture(addTwo(promises[i].getFuture()), &executor));
+    }
+    std::thread t([&promises]() {
+        for (size_t i = 0; i < promises.size(); i++) promises[i].setValue(i);
+    });
+    for (size_t i = 0; i < futures.size(); i++) EXPECT_EQ(static_cast<int>(i) + 2, futures[i].get());
+    t.join();
+}
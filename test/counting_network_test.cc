@@ -0,0 +1,76 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "counting_network.h"
+
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "bitonic.h"
+#include "gtest/gtest.h"
+
+template <typename T>
+class CountingNetworkTest : public testing::Test {
+};
+
+typedef testing::Types<wsd::Bitonic, wsd::Periodic, wsd::DiffractingTree> Networks;
+TYPED_TEST_CASE(CountingNetworkTest, Networks);
+
+TYPED_TEST(CountingNetworkTest, sequential)
+{
+    for (int i = 1; i < 10; ++i) {
+        int width = 1 << i;
+        TypeParam network(width);
+        wsd::CountingNetwork& counting = network;
+        EXPECT_EQ(width, counting.width());
+        // Every state is quiescent, so the k-th token leaves on wire k % width.
+        for (int k = 0; k < 3 * width; ++k) {
+            ASSERT_EQ(k % width, counting.Traverse(rand() % width));
+        }
+    }
+}
+
+TYPED_TEST(CountingNetworkTest, multithread)
+{
+    const int kWidth = 16;
+    const int kThreads = 32;
+    const int kTokens = 10000;
+    TypeParam network(kWidth);
+    std::vector<std::vector<int>> counts(kThreads, std::vector<int>(kWidth));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&, i]() {
+            for (int j = 0; j < kTokens; ++j) {
+                ++counts[i][network.Traverse(i % kWidth)];
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    // Quiescent now, and the tokens are a multiple of the width.
+    for (int wire = 0; wire < kWidth; ++wire) {
+        int n = 0;
+        for (int i = 0; i < kThreads; ++i) {
+            n += counts[i][wire];
+        }
+        EXPECT_EQ(kThreads * kTokens / kWidth, n);
+    }
+}
+
+TYPED_TEST(CountingNetworkTest, bad_width)
+{
+    EXPECT_THROW(TypeParam(1), std::invalid_argument);
+    EXPECT_THROW(TypeParam(12), std::invalid_argument);
+}
+
+TEST(Periodic, depth)
+{
+    EXPECT_EQ(1, wsd::Periodic(2).depth());
+    EXPECT_EQ(16, wsd::Periodic(16).depth());
+}
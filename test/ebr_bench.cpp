@@ -0,0 +1,64 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include <atomic>
+#include <mutex>
+
+#include "wsd/benchmark.h"
+#include "wsd/ebr.h"
+
+namespace {
+
+struct Node : wsd::EbrNode {
+    int value = 0;
+};
+
+}  // namespace
+
+class EbrBench : public wsd::benchmark::Test {
+public:
+    EbrBench() : m_current(new Node())
+    {
+    }
+
+    ~EbrBench()
+    {
+        delete m_current.load();
+    }
+
+protected:
+    wsd::EbrManager m_ebr;
+    std::atomic<Node*> m_current;
+    std::mutex m_mutex;
+};
+
+// The read path: entering and exiting a critical region.
+TEST_CASE(EbrBench, enter_exit)
+{
+    wsd::EbrGuard ebr_guard(m_ebr);
+    return 0;
+}
+
+TEST_CASE(EbrBench, read)
+{
+    wsd::EbrGuard ebr_guard(m_ebr);
+    return m_current.load(std::memory_order_acquire)->value;
+}
+
+TEST_CASE(EbrBench, mutex_read)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_current.load(std::memory_order_relaxed)->value;
+}
+
+// The write path: replacing and retiring a node.
+TEST_CASE(EbrBench, retire)
+{
+    Node* node = new Node();
+    wsd::EbrGuard ebr_guard(m_ebr);
+    m_ebr.RetireNode(m_current.exchange(node, std::memory_order_acq_rel));
+    return 0;
+}
@@ -7,8 +7,11 @@
 #include "ebr.h"
 
 #include <atomic>
+#include <chrono>
 #include <future>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -35,7 +38,7 @@ public:
     bool Dequeue(T* p);
 
 private:
-    struct NodeType {
+    struct NodeType : wsd::EbrNode {
         T data;
         std::atomic<NodeType*> next{nullptr};
     };
@@ -74,6 +77,7 @@ void FifoQueue<T>::Enqueue(T&& data)
 template <typename T>
 bool FifoQueue<T>::Dequeue(T* p)
 {
+    wsd::EbrGuard ebr_guard(m_ebr);
     NodeType* h = nullptr;
     while (true) {
         h = m_head.load();
@@ -92,6 +96,40 @@ bool FifoQueue<T>::Dequeue(T* p)
     return true;
 }
 
+struct Counted : wsd::EbrNode {
+    explicit Counted(std::atomic<int>* num_deleted) : num_deleted(num_deleted)
+    {
+    }
+
+    ~Counted()
+    {
+        num_deleted->fetch_add(1);
+    }
+
+    std::atomic<int>* num_deleted;
+};
+
+// Detects accesses to destroyed payloads.
+struct Payload : wsd::EbrNode {
+    explicit Payload(int v) : value(v), check(~v)
+    {
+    }
+
+    ~Payload()
+    {
+        value = 0;
+        check = 0;
+    }
+
+    bool IsValid() const
+    {
+        return value == ~check;
+    }
+
+    int value;
+    int check;
+};
+
 }  // namespace
 
 TEST(Ebr, fifo_queue)
@@ -102,3 +140,201 @@ TEST(Ebr, fifo_queue)
     EXPECT_TRUE(queue.Dequeue(&a));
     EXPECT_EQ(1, a);
 }
+
+TEST(Ebr, reclaim_in_batches)
+{
+    std::atomic<int> num_deleted{0};
+    wsd::EbrManager ebr(16);
+    for (int i = 0; i < 1000; ++i) {
+        wsd::EbrGuard ebr_guard(ebr);
+        ebr.RetireNode(new Counted(&num_deleted));
+        // Nodes are reclaimed two epochs after they are retired, and the epoch
+        // advances every 16 retires.
+        EXPECT_LE(i + 1 - 3 * 16, num_deleted.load());
+    }
+}
+
+TEST(Ebr, nested_guards)
+{
+    std::atomic<int> num_deleted{0};
+    wsd::EbrManager ebr(1);
+    wsd::EbrGuard outer_guard(ebr);
+    {
+        wsd::EbrGuard inner_guard(ebr);
+    }
+    // Still in the critical region started by the outer guard, which keeps the
+    // epoch from advancing twice in another thread.
+    std::thread([&ebr, &num_deleted]() {
+        for (int i = 0; i < 100; ++i) {
+            ebr.RetireNode(new Counted(&num_deleted));
+        }
+    }).join();
+    EXPECT_EQ(0, num_deleted.load());
+}
+
+TEST(Ebr, many_managers)
+{
+    std::atomic<int> num_deleted{0};
+    for (int i = 0; i < 100; ++i) {
+        wsd::EbrManager ebr1(1);
+        wsd::EbrManager ebr2(1);
+        for (int j = 0; j < 10; ++j) {
+            wsd::EbrGuard guard1(ebr1);
+            wsd::EbrGuard guard2(ebr2);
+            ebr1.RetireNode(new Counted(&num_deleted));
+            ebr2.RetireNode(new Counted(&num_deleted));
+        }
+    }
+    EXPECT_EQ(2000, num_deleted.load());
+}
+
+TEST(Ebr, retire_from_many_threads)
+{
+    const int kNumThreads = 4;
+    const int kNumRetiresPerThread = 10000;
+    std::atomic<int> num_deleted{0};
+    {
+        wsd::EbrManager ebr(16);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < kNumThreads; ++i) {
+            threads.emplace_back([&ebr, &num_deleted]() {
+                for (int j = 0; j < kNumRetiresPerThread; ++j) {
+                    wsd::EbrGuard ebr_guard(ebr);
+                    ebr.RetireNode(new Counted(&num_deleted));
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    EXPECT_EQ(kNumThreads * kNumRetiresPerThread, num_deleted.load());
+}
+
+TEST(Ebr, stats)
+{
+    std::atomic<int> num_deleted{0};
+    wsd::EbrManager ebr(16);
+    for (int i = 0; i < 1000; ++i) {
+        wsd::EbrGuard ebr_guard(ebr);
+        ebr.RetireNode(new Counted(&num_deleted));
+    }
+    // Up to 16 nodes are pending, and the others are counted until freed.
+    wsd::EbrManager::Stats stats = ebr.GetStats();
+    EXPECT_EQ(1000U, stats.num_unreclaimed + num_deleted.load() + 1000 % 16);
+    EXPECT_EQ(stats.num_unreclaimed * sizeof(Counted), stats.unreclaimed_bytes);
+    EXPECT_LE(stats.num_unreclaimed, 3U * 16);
+    EXPECT_EQ(1000U / 16, stats.epoch);
+    EXPECT_EQ(0U, stats.num_failed_advances);
+}
+
+TEST(Ebr, bounded_by_stalled_reader)
+{
+    const int kNumRetires = 1000;
+    const size_t kMaxBytes = 100 * sizeof(Counted);
+    std::atomic<int> num_deleted{0};
+    std::atomic<int> num_retired{0};
+    wsd::EbrManager::Options options;
+    options.reclaim_interval = 8;
+    options.max_unreclaimed_bytes = kMaxBytes;
+    wsd::EbrManager ebr(options);
+
+    std::promise<void> entered;
+    std::promise<void> resume;
+    std::thread reader([&]() {
+        wsd::EbrGuard ebr_guard(ebr);
+        entered.set_value();
+        resume.get_future().wait();
+    });
+    entered.get_future().wait();
+
+    std::thread writer([&]() {
+        for (int i = 0; i < kNumRetires; ++i) {
+            wsd::EbrGuard ebr_guard(ebr);
+            ebr.RetireNode(new Counted(&num_deleted));
+            num_retired.fetch_add(1);
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    // The writer waits for the reader, rather than retiring memory without bound.
+    wsd::EbrManager::Stats stats = ebr.GetStats();
+    EXPECT_GT(kNumRetires, num_retired.load());
+    EXPECT_GE(kMaxBytes + 8 * sizeof(Counted), stats.unreclaimed_bytes);
+    EXPECT_LT(0U, stats.num_failed_advances);
+
+    resume.set_value();
+    reader.join();
+    writer.join();
+    EXPECT_EQ(kNumRetires, num_retired.load());
+    EXPECT_GE(kMaxBytes + 8 * sizeof(Counted), ebr.GetStats().unreclaimed_bytes);
+}
+
+TEST(Ebr, background_reclaimer)
+{
+    const int kNumThreads = 4;
+    std::atomic<int> num_deleted{0};
+    wsd::EbrManager::Options options;
+    options.background_reclaim_interval_ms = 1;
+    wsd::EbrManager ebr(options);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&ebr, &num_deleted]() {
+            wsd::EbrGuard ebr_guard(ebr);
+            ebr.RetireNode(new Counted(&num_deleted));
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    // Nodes retired by the exited threads are freed in the background.
+    for (int i = 0; i < 5000 && num_deleted.load() < kNumThreads; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(kNumThreads, num_deleted.load());
+    EXPECT_EQ(0U, ebr.GetStats().num_unreclaimed);
+}
+
+// Readers access the current payload while writers replace and retire it. Run with
+// -fsanitize=thread or -fsanitize=address to catch unsafe reclamation.
+TEST(Ebr, stress)
+{
+    const int kNumReaders = 4;
+    const int kNumWriters = 2;
+    const int kNumWritesPerWriter = 20000;
+    wsd::EbrManager ebr(8);
+    std::atomic<Payload*> current{new Payload(0)};
+    std::atomic<bool> stop{false};
+    std::atomic<int> num_invalid{0};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kNumReaders; ++i) {
+        readers.emplace_back([&]() {
+            while (!stop.load(std::memory_order_relaxed)) {
+                wsd::EbrGuard ebr_guard(ebr);
+                Payload* p = current.load(std::memory_order_acquire);
+                if (!p->IsValid()) {
+                    num_invalid.fetch_add(1);
+                }
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int i = 0; i < kNumWriters; ++i) {
+        writers.emplace_back([&, i]() {
+            for (int j = 0; j < kNumWritesPerWriter; ++j) {
+                Payload* p = new Payload(i * kNumWritesPerWriter + j);
+                wsd::EbrGuard ebr_guard(ebr);
+                ebr.RetireNode(current.exchange(p, std::memory_order_acq_rel));
+            }
+        });
+    }
+    for (auto& t : writers) {
+        t.join();
+    }
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    delete current.load();
+    EXPECT_EQ(0, num_invalid.load());
+}
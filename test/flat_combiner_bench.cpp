@@ -0,0 +1,84 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+// Compare the cases with increasing --concurrency to see where flat combining starts
+// to beat a mutex around the same sequential structure.
+
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "wsd/benchmark.h"
+#include "wsd/flat_combining_lru_cache.h"
+#include "wsd/flat_combining_priority_queue.h"
+
+namespace {
+
+const int kKeys = 4096;
+
+int NextKey()
+{
+    static thread_local std::minstd_rand s_random(std::random_device{}());
+    return static_cast<int>(s_random() % kKeys);
+}
+
+}  // namespace
+
+// Looks up keys, putting the missing ones, in a cache holding half of them.
+class LruCacheBench : public wsd::benchmark::Test {
+protected:
+    wsd::FlatCombiningLruCache<int, int> m_flat_combining{kKeys / 2};
+    wsd::detail::LruCache<int, int, std::hash<int>> m_cache{kKeys / 2};
+    std::mutex m_mutex;
+};
+
+TEST_CASE(LruCacheBench, flat_combining)
+{
+    int key = NextKey();
+    int value = 0;
+    if (!m_flat_combining.Get(key, &value)) {
+        m_flat_combining.Put(key, key);
+    }
+    return value;
+}
+
+TEST_CASE(LruCacheBench, mutex)
+{
+    int key = NextKey();
+    int value = 0;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_cache.Get(key, &value)) {
+        m_cache.Put(key, key);
+    }
+    return value;
+}
+
+// Each operation pushes a value and pops the least one, so the heap stays small.
+class PriorityQueueBench : public wsd::benchmark::Test {
+protected:
+    wsd::FlatCombiningPriorityQueue<int, std::greater<int>> m_flat_combining;
+    std::priority_queue<int, std::vector<int>, std::greater<int>> m_queue;
+    std::mutex m_mutex;
+};
+
+TEST_CASE(PriorityQueueBench, flat_combining)
+{
+    int value = 0;
+    m_flat_combining.Push(NextKey());
+    m_flat_combining.TryPop(&value);
+    return value;
+}
+
+TEST_CASE(PriorityQueueBench, mutex)
+{
+    int value = NextKey();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.push(value);
+    value = m_queue.top();
+    m_queue.pop();
+    return value;
+}
@@ -0,0 +1,166 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "wsd/flat_combiner.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "wsd/flat_combining_lru_cache.h"
+#include "wsd/flat_combining_priority_queue.h"
+
+namespace {
+
+const int kThreads = 8;
+
+template <typename F>
+void RunThreads(F f)
+{
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back(f, i);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+}  // namespace
+
+TEST(FlatCombiner, counter)
+{
+    wsd::FlatCombiner<std::vector<int>> combiner;
+    RunThreads([&](int i) {
+        for (int j = 0; j < 10000; ++j) {
+            combiner.Apply([i, j](std::vector<int>& v) { v.push_back(i * 10000 + j); });
+        }
+    });
+    std::vector<int> all = combiner.Apply([](std::vector<int>& v) { return v; });
+    ASSERT_EQ(static_cast<size_t>(kThreads * 10000), all.size());
+    std::sort(all.begin(), all.end());
+    for (int i = 0; i < kThreads * 10000; ++i) {
+        ASSERT_EQ(i, all[i]);
+    }
+    EXPECT_GE(combiner.average_batch_size(), 1.0);
+}
+
+TEST(FlatCombiner, result)
+{
+    wsd::FlatCombiner<int> combiner(40);
+    EXPECT_EQ(42, combiner.Apply([](int& n) { return n += 2; }));
+    std::string s = combiner.Apply([](int& n) { return std::to_string(n); });
+    EXPECT_EQ("42", s);
+}
+
+TEST(FlatCombiner, exception)
+{
+    wsd::FlatCombiner<int> combiner(0);
+    EXPECT_THROW(combiner.Apply([](int&) -> int { throw std::runtime_error("op"); }), std::runtime_error);
+    EXPECT_THROW(combiner.Apply([](int&) { throw std::runtime_error("op"); }), std::runtime_error);
+    // The combiner is still usable.
+    EXPECT_EQ(1, combiner.Apply([](int& n) { return ++n; }));
+}
+
+TEST(FlatCombiner, records_reused)
+{
+    wsd::FlatCombiner<int> combiner(0);
+    for (int round = 0; round < 10; ++round) {
+        RunThreads([&](int) {
+            for (int j = 0; j < 100; ++j) {
+                combiner.Apply([](int& n) { ++n; });
+            }
+        });
+    }
+    EXPECT_EQ(10 * kThreads * 100, combiner.Apply([](int& n) { return n; }));
+    EXPECT_LE(combiner.num_records(), static_cast<size_t>(kThreads));
+}
+
+TEST(FlatCombiningLruCache, evict)
+{
+    wsd::FlatCombiningLruCache<int, std::string> cache(2);
+    std::string value;
+    EXPECT_FALSE(cache.Get(1, &value));
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+    ASSERT_TRUE(cache.Get(1, &value));
+    EXPECT_EQ("one", value);
+    // 2 is the least recently used.
+    cache.Put(3, "three");
+    EXPECT_FALSE(cache.Get(2, &value));
+    EXPECT_TRUE(cache.Get(1, &value));
+    EXPECT_TRUE(cache.Get(3, &value));
+    cache.Put(3, "drei");
+    cache.Put(4, "four");
+    EXPECT_FALSE(cache.Get(1, &value));
+    ASSERT_TRUE(cache.Get(3, &value));
+    EXPECT_EQ("drei", value);
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_TRUE(cache.Erase(3));
+    EXPECT_FALSE(cache.Erase(3));
+    EXPECT_EQ(1u, cache.size());
+}
+
+TEST(FlatCombiningLruCache, concurrent)
+{
+    const int kKeys = 64;
+    wsd::FlatCombiningLruCache<int, int> cache(kKeys / 2);
+    RunThreads([&](int i) {
+        for (int j = 0; j < 10000; ++j) {
+            int key = (i * 7 + j) % kKeys;
+            int value;
+            if (cache.Get(key, &value)) {
+                ASSERT_EQ(key * 2, value);
+            } else {
+                cache.Put(key, key * 2);
+            }
+        }
+    });
+    EXPECT_EQ(static_cast<size_t>(kKeys / 2), cache.size());
+}
+
+TEST(FlatCombiningPriorityQueue, order)
+{
+    wsd::FlatCombiningPriorityQueue<int, std::greater<int>> queue;
+    RunThreads([&](int i) {
+        for (int j = 0; j < 1000; ++j) {
+            queue.Push(j * kThreads + i);
+        }
+    });
+    EXPECT_EQ(static_cast<size_t>(kThreads * 1000), queue.size());
+    int value;
+    for (int i = 0; i < kThreads * 1000; ++i) {
+        ASSERT_TRUE(queue.TryPop(&value));
+        ASSERT_EQ(i, value);
+    }
+    EXPECT_FALSE(queue.TryPop(&value));
+}
+
+TEST(FlatCombiningPriorityQueue, concurrent)
+{
+    wsd::FlatCombiningPriorityQueue<int> queue;
+    std::vector<std::vector<int>> popped(kThreads);
+    RunThreads([&](int i) {
+        for (int j = 0; j < 1000; ++j) {
+            queue.Push(i * 1000 + j);
+            int value;
+            ASSERT_TRUE(queue.TryPop(&value));
+            popped[i].push_back(value);
+        }
+    });
+    std::vector<int> all;
+    for (const auto& p : popped) {
+        all.insert(all.end(), p.begin(), p.end());
+    }
+    std::sort(all.begin(), all.end());
+    for (int i = 0; i < kThreads * 1000; ++i) {
+        ASSERT_EQ(i, all[i]);
+    }
+}
@@ -0,0 +1,54 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include <atomic>
+
+#include "wsd/benchmark.h"
+#include "wsd/hazard_pointer.h"
+
+namespace {
+
+struct Node {
+    int value = 0;
+};
+
+}  // namespace
+
+class HazardPointerBench : public wsd::benchmark::Test {
+public:
+    HazardPointerBench() : m_current(new Node())
+    {
+    }
+
+    ~HazardPointerBench()
+    {
+        delete m_current.load();
+    }
+
+protected:
+    wsd::HazardManager m_hazard_manager{1};
+    std::atomic<Node*> m_current;
+};
+
+TEST_CASE(HazardPointerBench, read)
+{
+    wsd::HazardPointer hp(m_hazard_manager);
+    return hp.Protect(m_current)->value;
+}
+
+// The write path: replacing and retiring a node.
+TEST_CASE(HazardPointerBench, retire)
+{
+    m_hazard_manager.RetireNode(m_current.exchange(new Node(), std::memory_order_acq_rel));
+    return 0;
+}
+
+// The cost of allocating and freeing the nodes, for comparison with retire.
+TEST_CASE(HazardPointerBench, delete)
+{
+    delete m_current.exchange(new Node(), std::memory_order_acq_rel);
+    return 0;
+}
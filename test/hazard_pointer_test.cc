@@ -7,8 +7,13 @@
 #include "hazard_pointer.h"
 
 #include <atomic>
+#include <chrono>
 #include <future>
+#include <memory>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -52,9 +57,7 @@ void FifoQueue<T>::Enqueue(T&& data)
     node->next = nullptr;
     NodeType* t = nullptr;
     while (true) {
-        t = m_tail.load();
-        hp.Acquire(t);
-        if (m_tail.load() != t) continue;
+        t = hp.Protect(m_tail);
         NodeType* next = t->next.load();
         if (m_tail.load() != t) {
             continue;
@@ -74,16 +77,13 @@ void FifoQueue<T>::Enqueue(T&& data)
 template <typename T>
 bool FifoQueue<T>::Dequeue(T* p)
 {
-    wsd::HazardPointer hp(m_hazard_manager, 0);
-    wsd::HazardPointer hp1(m_hazard_manager, 1);
+    wsd::HazardPointerArray<2> hps(m_hazard_manager);
     NodeType* h = nullptr;
     while (true) {
-        h = m_head.load();
-        hp.Acquire(h);
-        if (m_head.load() != h) continue;
+        h = hps[0].Protect(m_head);
         NodeType* t = m_tail.load();
-        NodeType* next = h->next.load();
-        hp1.Acquire(next);
+        NodeType* next = hps[1].Protect(h->next);
+        // Otherwise `next' may have been dequeued and retired already.
         if (h != m_head.load()) continue;
         if (next == nullptr) return false;
         if (h == t) {
@@ -109,23 +109,20 @@ TEST(HazardPointer, fifo_queue)
 TEST(HazardPointer, SequentialExecution)
 {
     wsd::HazardManager hp_mgr(1);
-    wsd::HazardPointer hp(hp_mgr, 0);
+    wsd::HazardPointer hp(hp_mgr);
     int a;
     hp.Acquire(&a);
     EXPECT_EQ(1, hp_mgr.TEST_GetNumberOfHp());
     hp.Release();
     EXPECT_EQ(0, hp_mgr.TEST_GetNumberOfHp());
-
-    EXPECT_THROW(wsd::HazardPointer(hp_mgr, 1), std::invalid_argument);
 }
 
 TEST(HazardPointer, SequentialExecution2)
 {
     wsd::HazardManager hp_mgr(2);
     {
-        wsd::HazardPointer hp1(hp_mgr, 0);
-        wsd::HazardPointer hp2(hp_mgr, 1);
-        EXPECT_THROW(wsd::HazardPointer(hp_mgr, 2), std::invalid_argument);
+        wsd::HazardPointer hp1(hp_mgr);
+        wsd::HazardPointer hp2(hp_mgr);
 
         int a, b;
         hp1.Acquire(&a);
@@ -153,7 +150,7 @@ TEST(HazardPointer, SequentialExecution2)
 TEST(HazardPointer, SequentialExecution3)
 {
     wsd::HazardManager hp_mgr(1);
-    wsd::HazardPointer hp1(hp_mgr, 0);
+    wsd::HazardPointer hp1(hp_mgr);
     int* p = new int;
     hp1.Acquire(p);
     EXPECT_TRUE(hp_mgr.TEST_HpListContains(p));
@@ -173,6 +170,145 @@ TEST(HazardPointer, SequentialExecution3)
     EXPECT_EQ(0, hp_mgr.TEST_GetRetireListLenOfCurrentThread());
 }
 
+TEST(HazardPointer, Protect)
+{
+    wsd::HazardManager hp_mgr(1);
+    int* p = new int;
+    std::atomic<int*> src{p};
+    {
+        wsd::HazardPointer hp(hp_mgr);
+        EXPECT_EQ(p, hp.Protect(src));
+        EXPECT_TRUE(hp_mgr.TEST_HpListContains(p));
+        hp_mgr.RetireNode(src.exchange(nullptr));
+        hp_mgr.RetireNode(new int);
+        // Still protected.
+        EXPECT_TRUE(hp_mgr.TEST_RetireListContains(p));
+        EXPECT_EQ(nullptr, hp.Protect(src));
+    }
+    hp_mgr.RetireNode(new int);
+    EXPECT_FALSE(hp_mgr.TEST_RetireListContains(p));
+}
+
+TEST(HazardPointer, ManagerAtAddressOfDestroyedOne)
+{
+    // A thread keeps its record of a destroyed manager until it uses another manager, which
+    // must not take that record for a new manager at the same address.
+    std::aligned_storage<sizeof(wsd::HazardManager), alignof(wsd::HazardManager)>::type
+        storage;
+    auto* hp_mgr = new (&storage) wsd::HazardManager(1);
+    int* p = new int;
+    std::atomic<int*> src{p};
+    std::promise<void> first_used;
+    std::promise<void> recreated;
+    std::promise<void> protected_;
+    std::promise<void> retired;
+    std::thread t([&]() {
+        {
+            wsd::HazardPointer hp(*hp_mgr);
+        }
+        first_used.set_value();
+        recreated.get_future().wait();
+        wsd::HazardPointer hp(*hp_mgr);
+        EXPECT_EQ(p, hp.Protect(src));
+        protected_.set_value();
+        retired.get_future().wait();
+    });
+    first_used.get_future().wait();
+    hp_mgr->~HazardManager();
+    hp_mgr = new (&storage) wsd::HazardManager(1);
+    recreated.set_value();
+    protected_.get_future().wait();
+    EXPECT_TRUE(hp_mgr->TEST_HpListContains(p));
+    hp_mgr->RetireNode(src.exchange(nullptr));
+    for (int i = 0; i < 10; ++i) {
+        hp_mgr->RetireNode(new int);
+    }
+    // Still protected.
+    EXPECT_TRUE(hp_mgr->TEST_RetireListContains(p));
+    retired.set_value();
+    t.join();
+    hp_mgr->~HazardManager();
+}
+
+TEST(HazardPointer, HazardPointerArray)
+{
+    wsd::HazardManager hp_mgr(3);
+    int a = 0;
+    int b = 0;
+    std::atomic<int*> src_a{&a};
+    std::atomic<int*> src_b{&b};
+    {
+        wsd::HazardPointerArray<2> hps(hp_mgr);
+        EXPECT_EQ(2U, hps.size());
+        EXPECT_EQ(&a, hps[0].Protect(src_a));
+        EXPECT_EQ(&b, hps[1].Protect(src_b));
+        EXPECT_EQ(2, hp_mgr.TEST_GetNumberOfHp());
+        wsd::HazardPointer hp(hp_mgr);
+        hp.Acquire(&a);
+        EXPECT_EQ(3, hp_mgr.TEST_GetNumberOfHp());
+    }
+    EXPECT_EQ(0, hp_mgr.TEST_GetNumberOfHp());
+}
+
+TEST(HazardPointer, DynamicSlots)
+{
+    const int kNumHps = 100;
+    wsd::HazardManager hp_mgr(1);
+    std::vector<int> nodes(kNumHps);
+    {
+        // E.g. a traversal protecting every node on the path.
+        std::vector<std::unique_ptr<wsd::HazardPointer>> hps;
+        for (int i = 0; i < kNumHps; ++i) {
+            hps.emplace_back(new wsd::HazardPointer(hp_mgr));
+            hps.back()->Acquire(&nodes[i]);
+        }
+        EXPECT_EQ(kNumHps, hp_mgr.TEST_GetNumberOfHp());
+        EXPECT_TRUE(hp_mgr.TEST_HpListContains(&nodes[0]));
+        EXPECT_TRUE(hp_mgr.TEST_HpListContains(&nodes[kNumHps - 1]));
+        EXPECT_LE(static_cast<size_t>(kNumHps), hp_mgr.GetStats().num_live_slots);
+    }
+    EXPECT_EQ(0, hp_mgr.TEST_GetNumberOfHp());
+
+    // Released slots are reused.
+    size_t num_live_slots = hp_mgr.GetStats().num_live_slots;
+    for (int i = 0; i < kNumHps; ++i) {
+        wsd::HazardPointerArray<2> hps(hp_mgr);
+        hps[0].Acquire(&nodes[0]);
+        hps[1].Acquire(&nodes[1]);
+    }
+    EXPECT_EQ(num_live_slots, hp_mgr.GetStats().num_live_slots);
+}
+
+TEST(HazardPointer, ScanThresholdFollowsLiveSlots)
+{
+    const int kNumThreads = 8;
+    wsd::HazardManager hp_mgr(4);
+    std::vector<std::thread> threads;
+    std::promise<void> done;
+    std::shared_future<void> all_done(done.get_future());
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&hp_mgr, all_done]() {
+            wsd::HazardPointer hp(hp_mgr);
+            all_done.wait();
+        });
+    }
+    for (int i = 0; i < 100 && hp_mgr.GetStats().num_live_slots < 4U * kNumThreads; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(4U * kNumThreads, hp_mgr.GetStats().num_live_slots);
+    done.set_value();
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(0U, hp_mgr.GetStats().num_live_slots);
+
+    // The slots of the exited threads do not delay scans.
+    for (int i = 0; i < 8; ++i) {
+        hp_mgr.RetireNode(new int);
+    }
+    EXPECT_EQ(0, hp_mgr.TEST_GetRetireListLenOfCurrentThread());
+}
+
 TEST(HazardPointer, ConcurrentExecution)
 {
     wsd::HazardManager hp_mgr(1);
@@ -186,7 +322,7 @@ TEST(HazardPointer, ConcurrentExecution)
     std::shared_future<void> ready2(go2.get_future());
 
     std::future<void> done1 = std::async(std::launch::async, [&, ready, p, ready2]() {
-        wsd::HazardPointer hp(hp_mgr, 0);
+        wsd::HazardPointer hp(hp_mgr);
         thread1_ready.set_value();
         ready.wait();
         hp.Acquire(p);
@@ -195,7 +331,7 @@ TEST(HazardPointer, ConcurrentExecution)
         ready2.wait();
     });
     std::future<void> done2 = std::async(std::launch::async, [&, ready, p, ready2]() {
-        wsd::HazardPointer hp(hp_mgr, 0);
+        wsd::HazardPointer hp(hp_mgr);
         thread2_ready.set_value();
         ready.wait();
         hp.Acquire(p);
@@ -234,7 +370,7 @@ TEST(HazardPointer, ConcurrentExecution2)
     std::shared_future<void> ready2(go2.get_future());
 
     std::future<void> done1 = std::async(std::launch::async, [&, ready, p, ready2]() {
-        wsd::HazardPointer hp(hp_mgr, 0);
+        wsd::HazardPointer hp(hp_mgr);
         thread1_ready.set_value();
         ready.wait();
         hp.Acquire(p);
@@ -243,7 +379,7 @@ TEST(HazardPointer, ConcurrentExecution2)
         ready2.wait();
     });
     std::future<void> done2 = std::async(std::launch::async, [&, ready, p, ready2]() {
-        wsd::HazardPointer hp(hp_mgr, 0);
+        wsd::HazardPointer hp(hp_mgr);
         thread2_ready.set_value();
         ready.wait();
         hp.Acquire(p);
@@ -269,3 +405,119 @@ TEST(HazardPointer, ConcurrentExecution2)
     EXPECT_FALSE(hp_mgr.TEST_HpListContains(p));
     EXPECT_EQ(0, hp_mgr.TEST_GetNumberOfHp());
 }
+
+TEST(HazardPointer, Stats)
+{
+    wsd::HazardManager hp_mgr(1);
+    wsd::HazardPointer hp(hp_mgr);
+    int* p = new int;
+    hp.Acquire(p);
+    hp_mgr.RetireNode(p);
+    // Counted on the next scan.
+    EXPECT_EQ(0U, hp_mgr.GetStats().num_unreclaimed);
+    hp_mgr.RetireNode(new int);
+    wsd::HazardManager::Stats stats = hp_mgr.GetStats();
+    EXPECT_EQ(1U, stats.num_unreclaimed);
+    EXPECT_EQ(sizeof(int), stats.unreclaimed_bytes);
+    EXPECT_EQ(1U, stats.num_live_slots);
+
+    hp.Release();
+    hp_mgr.RetireNode(new int);
+    hp_mgr.RetireNode(new int);
+    EXPECT_EQ(0U, hp_mgr.GetStats().num_unreclaimed);
+}
+
+TEST(HazardPointer, MaxUnreclaimedBytes)
+{
+    wsd::HazardManager::Options options;
+    options.max_unreclaimed_bytes = 4 * sizeof(int);
+    wsd::HazardManager hp_mgr(64, options);
+    for (int i = 0; i < 1000; ++i) {
+        hp_mgr.RetireNode(new int);
+        // Scans long before 2 * 64 nodes are retired.
+        EXPECT_GE(4, hp_mgr.TEST_GetRetireListLenOfCurrentThread());
+    }
+}
+
+TEST(HazardPointer, BackgroundReclaimer)
+{
+    const int kNumThreads = 4;
+    wsd::HazardManager::Options options;
+    options.background_reclaim_interval_ms = 1;
+    wsd::HazardManager hp_mgr(1, options);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&hp_mgr]() {
+            hp_mgr.RetireNode(new int);
+            hp_mgr.RetireNode(new int);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    // Nodes retired by the exited threads are freed in the background.
+    for (int i = 0; i < 5000 && hp_mgr.GetStats().num_unreclaimed > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(0U, hp_mgr.GetStats().num_unreclaimed);
+}
+
+// Readers access the current payload while writers replace and retire it. Run with
+// -fsanitize=thread or -fsanitize=address to catch unsafe reclamation.
+TEST(HazardPointer, Stress)
+{
+    struct Payload {
+        explicit Payload(int v) : value(v), check(~v)
+        {
+        }
+
+        ~Payload()
+        {
+            value = 0;
+            check = 0;
+        }
+
+        int value;
+        int check;
+    };
+
+    const int kNumReaders = 4;
+    const int kNumWriters = 2;
+    const int kNumWritesPerWriter = 20000;
+    wsd::HazardManager hp_mgr(1);
+    std::atomic<Payload*> current{new Payload(0)};
+    std::atomic<bool> stop{false};
+    std::atomic<int> num_invalid{0};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kNumReaders; ++i) {
+        readers.emplace_back([&]() {
+            wsd::HazardPointer hp(hp_mgr);
+            while (!stop.load(std::memory_order_relaxed)) {
+                Payload* p = hp.Protect(current);
+                if (p->value != ~p->check) {
+                    num_invalid.fetch_add(1);
+                }
+                hp.Release();
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int i = 0; i < kNumWriters; ++i) {
+        writers.emplace_back([&, i]() {
+            for (int j = 0; j < kNumWritesPerWriter; ++j) {
+                Payload* p = new Payload(i * kNumWritesPerWriter + j);
+                hp_mgr.RetireNode(current.exchange(p, std::memory_order_acq_rel));
+            }
+        });
+    }
+    for (auto& t : writers) {
+        t.join();
+    }
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    delete current.load();
+    EXPECT_EQ(0, num_invalid.load());
+}
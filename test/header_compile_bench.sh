@@ -0,0 +1,43 @@
+#!/bin/bash
+#
+# Measures the compile time and the object size of translation units, by default
+# test/*_header_test.cc. Other sources can be given as arguments, e.g.
+#
+#   test/header_compile_bench.sh test/callback_test.cc test/promise_test.cc
+#
+# CXX and CXXFLAGS are honored. Each file is compiled RUNS times (3 by default)
+# and the lowest CPU time (user + sys) is reported.
+
+set -e
+
+TIMEFORMAT='%3U %3S'
+
+cd "$(dirname "$0")/.."
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--std=c++11 -O2}
+RUNS=${RUNS:-3}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+if [ $# -eq 0 ]; then
+    set -- test/*_header_test.cc
+fi
+
+total_ms=0
+total_size=0
+printf "%-45s %10s %10s\n" "file" "time(ms)" "text(B)"
+for src in "$@"; do
+    obj="$OUT/$(basename "$src").o"
+    best=
+    for ((i = 0; i < RUNS; i++)); do
+        { time $CXX $CXXFLAGS -Iinclude -Iinclude/wsd -Itest -c "$src" -o "$obj" 2>&3; } 3>&2 2>"$OUT/time"
+        ms=$(awk '{ printf "%d", ($1 + $2) * 1000 }' "$OUT/time")
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    size=$(size "$obj" | awk 'NR == 2 { print $1 }')
+    printf "%-45s %10d %10d\n" "$src" "$best" "$size"
+    total_ms=$((total_ms + best))
+    total_size=$((total_size + size))
+done
+printf "%-45s %10d %10d\n" "total" "$total_ms" "$total_size"
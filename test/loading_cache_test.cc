@@ -28,7 +28,7 @@ Future<int> getException(const int&)
 TEST(LoadingCache, constructor)
 {
     LoadingCache<int, int> cache;
-    cache.setLoader(bind(&getInt));
+    cache.setLoader(wsd::bind(&getInt));
     EXPECT_EQ(0U, cache.size());
 
     Future<int> fuInt = cache.get(1);
@@ -38,7 +38,7 @@ TEST(LoadingCache, constructor)
     EXPECT_EQ(2U, cache.size());
 
     // An exception was thrown, and the cache size stays the same.
-    cache.setLoader(bind(&getException));
+    cache.setLoader(wsd::bind(&getException));
     EXPECT_THROW(cache.get(3).get(), const char*);
     EXPECT_EQ(2U, cache.size());
 }
@@ -52,7 +52,7 @@ TEST(LoadingCache, refresh)
 {
     LoadingCache<int, int> cache;
     cache.refreshAfter(1000);
-    cache.setLoader(bind(&getInt), bind(&regetInt));
+    cache.setLoader(wsd::bind(&getInt), wsd::bind(&regetInt));
     cache.get(1);
     sleep(2);
     cache.get(1);
@@ -70,7 +70,7 @@ TEST(LoadingCache, refresh_exception)
 {
     LoadingCache<int, int> cache;
     cache.refreshAfter(1000);
-    cache.setLoader(bind(&getInt), bind(&regetIntException));
+    cache.setLoader(wsd::bind(&getInt), wsd::bind(&regetIntException));
     cache.get(1);
     sleep(1);
 
@@ -79,7 +79,7 @@ TEST(LoadingCache, refresh_exception)
 
     // Now update.
     sleep(1);
-    cache.setLoader(bind(&getInt), bind(&regetInt));
+    cache.setLoader(wsd::bind(&getInt), wsd::bind(&regetInt));
     EXPECT_EQ(2, cache.get(1).get());
 }
 
@@ -89,7 +89,7 @@ TEST(LoadingCache, capacity)
 
     // 2 values are inserted.
     cache.setCapacity(2);
-    cache.setLoader(bind(&getInt));
+    cache.setLoader(wsd::bind(&getInt));
     cache.get(1);
     cache.get(2);
     EXPECT_EQ(2U, cache.size());
@@ -127,7 +127,7 @@ TEST(LoadingCache, capacity)
 TEST(LoadingCache, refresh_lru)
 {
     LoadingCache<int, int> cache;
-    cache.setLoader(bind(&getInt));
+    cache.setLoader(wsd::bind(&getInt));
     cache.setCapacity(4);
     cache.refreshAfter(500);
     cache.put(1, 1);
@@ -191,7 +191,7 @@ Future<int> delayGetInt(const int&)
 TEST(LoadingCache, delay_get_int)
 {
     LoadingCache<int, int> cache;
-    cache.setLoader(bind(&delayGetInt));
+    cache.setLoader(wsd::bind(&delayGetInt));
     cache.refreshAfter(1000);
 
     cache.get(1);
@@ -204,7 +204,7 @@ TEST(LoadingCache, delay_get_int)
 TEST(LoadingCache, delay_refresh_exception)
 {
     LoadingCache<int, int> cache;
-    cache.setLoader(bind(&delayGetInt), bind(&regetIntException));
+    cache.setLoader(wsd::bind(&delayGetInt), wsd::bind(&regetIntException));
     cache.refreshAfter(1000);
 
     cache.get(1);
@@ -220,7 +220,7 @@ TEST(LoadingCache, delay_refresh_exception)
 TEST(LoadingCache, evictionCount)
 {
     LoadingCache<int, int> cache;
-    cache.setLoader(bind(&getInt));
+    cache.setLoader(wsd::bind(&getInt));
     cache.setCapacity(2);
     cache.get(1);
     cache.get(2);
@@ -230,3 +230,20 @@ TEST(LoadingCache, evictionCount)
     cache.get(4);
     EXPECT_EQ(2, cache.stats().evictionCount());
 }
+
+Promise<int> g_slowLoad;
+
+Future<int> slowGetInt(const int&)
+{
+    return g_slowLoad.getFuture();
+}
+
+TEST(LoadingCache, expired_load_is_cancelled)
+{
+    LoadingCache<int, int> cache;
+    cache.setLoader(wsd::bind(&slowGetInt));
+    cache.expireAfter(50);
+
+    EXPECT_THROW(cache.get(1).get(), FutureTimeoutException);
+    EXPECT_TRUE(g_slowLoad.isInterrupted());
+}
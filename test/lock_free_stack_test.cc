@@ -0,0 +1,188 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "lock_free_stack.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+template <typename Stack>
+class LockFreeStackTest : public ::testing::Test {};
+
+typedef ::testing::Types<wsd::LockFreeStack<int>, wsd::EliminationBackoffStack<int>> StackTypes;
+TYPED_TEST_CASE(LockFreeStackTest, StackTypes);
+
+TYPED_TEST(LockFreeStackTest, lifo)
+{
+    TypeParam stack;
+    int v = 0;
+    EXPECT_FALSE(stack.TryPop(&v));
+    for (int i = 0; i < 100; ++i) {
+        stack.Push(i);
+    }
+    for (int i = 99; i >= 0; --i) {
+        EXPECT_TRUE(stack.TryPop(&v));
+        EXPECT_EQ(i, v);
+    }
+    EXPECT_FALSE(stack.TryPop(&v));
+}
+
+// Threads pop the values pushed, as object pools do with a free list. Every value is
+// popped exactly once.
+TYPED_TEST(LockFreeStackTest, free_list)
+{
+    TypeParam stack;
+    const int kThreads = 8;
+    const int kValues = 64;
+    const int kRounds = 20000;
+    for (int i = 0; i < kValues; ++i) {
+        stack.Push(i);
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < kRounds; ++i) {
+                int v = 0;
+                if (stack.TryPop(&v)) {
+                    stack.Push(v);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::vector<int> seen(kValues, 0);
+    int v = 0;
+    while (stack.TryPop(&v)) {
+        ASSERT_TRUE(v >= 0 && v < kValues);
+        ++seen[v];
+    }
+    for (int i = 0; i < kValues; ++i) {
+        EXPECT_EQ(1, seen[i]) << i;
+    }
+}
+
+TYPED_TEST(LockFreeStackTest, producers_and_consumers)
+{
+    TypeParam stack;
+    const int kThreads = 4;
+    const int kNum = 20000;
+    std::atomic<long> sum{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 1; i <= kNum; ++i) {
+                stack.Push(i);
+            }
+        });
+        threads.emplace_back([&]() {
+            long local = 0;
+            for (int i = 0; i < kNum;) {
+                int v = 0;
+                if (stack.TryPop(&v)) {
+                    local += v;
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            sum += local;
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(static_cast<long>(kThreads) * kNum * (kNum + 1) / 2, sum.load());
+}
+
+TYPED_TEST(LockFreeStackTest, stacks_created_and_destroyed_while_threads_live)
+{
+    // Every stack owns a hazard manager, and a new stack is likely allocated where the last
+    // one was, while the threads still have records of the destroyed ones.
+    const int kThreads = 4;
+    const int kRounds = 200;
+    std::atomic<TypeParam*> stack{nullptr};
+    std::atomic<int> round{0};
+    std::atomic<int> num_done{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (int r = 1; r <= kRounds; ++r) {
+                while (round.load() != r) {
+                    std::this_thread::yield();
+                }
+                auto* s = stack.load();
+                for (int i = 0; i < 100; ++i) {
+                    s->Push(i);
+                    int v = 0;
+                    while (!s->TryPop(&v)) {
+                        std::this_thread::yield();
+                    }
+                }
+                ++num_done;
+            }
+        });
+    }
+    for (int r = 1; r <= kRounds; ++r) {
+        std::unique_ptr<TypeParam> s(new TypeParam());
+        stack.store(s.get());
+        round.store(r);
+        while (num_done.load() != kThreads * r) {
+            std::this_thread::yield();
+        }
+        int v = 0;
+        EXPECT_FALSE(s->TryPop(&v));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+TEST(LockFreeStack, move_only)
+{
+    wsd::LockFreeStack<std::unique_ptr<int>> stack;
+    stack.Push(std::unique_ptr<int>(new int(1)));
+    stack.Push(std::unique_ptr<int>(new int(2)));
+    std::unique_ptr<int> p;
+    EXPECT_TRUE(stack.TryPop(&p));
+    EXPECT_EQ(2, *p);
+    // The remaining element is destroyed with the stack.
+}
+
+TEST(EliminationBackoffStack, eliminates)
+{
+    // A single exchanger and long waits make pushes and pops meet often.
+    wsd::EliminationBackoffStack<int> stack(1, 1 << 14);
+    const int kNum = 20000;
+    std::atomic<long> sum{0};
+    std::thread pusher([&]() {
+        for (int i = 1; i <= kNum; ++i) {
+            stack.Push(i);
+        }
+    });
+    std::thread popper([&]() {
+        long local = 0;
+        for (int i = 0; i < kNum;) {
+            int v = 0;
+            if (stack.TryPop(&v)) {
+                local += v;
+                ++i;
+            }
+        }
+        sum = local;
+    });
+    pusher.join();
+    popper.join();
+    EXPECT_EQ(static_cast<long>(kNum) * (kNum + 1) / 2, sum.load());
+    int v = 0;
+    EXPECT_FALSE(stack.TryPop(&v));
+    EXPECT_EQ(0u, stack.num_eliminated() % 2);
+}
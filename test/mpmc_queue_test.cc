@@ -0,0 +1,111 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "mpmc_queue.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(BoundedMpmcQueue, capacity)
+{
+    EXPECT_EQ(2u, wsd::BoundedMpmcQueue<int>(0).capacity());
+    EXPECT_EQ(8u, wsd::BoundedMpmcQueue<int>(8).capacity());
+    EXPECT_EQ(16u, wsd::BoundedMpmcQueue<int>(9).capacity());
+}
+
+TEST(BoundedMpmcQueue, fifo)
+{
+    wsd::BoundedMpmcQueue<int> queue(4);
+    int v = 0;
+    EXPECT_FALSE(queue.TryPop(&v));
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(queue.TryPush(i));
+        }
+        EXPECT_FALSE(queue.TryPush(4));
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(queue.TryPop(&v));
+            EXPECT_EQ(i, v);
+        }
+        EXPECT_FALSE(queue.TryPop(&v));
+    }
+}
+
+TEST(BoundedMpmcQueue, move_only)
+{
+    wsd::BoundedMpmcQueue<std::unique_ptr<int>> queue(2);
+    std::unique_ptr<int> p(new int(1));
+    EXPECT_TRUE(queue.TryPush(std::move(p)));
+    EXPECT_FALSE(p);
+    p.reset(new int(2));
+    EXPECT_TRUE(queue.TryPush(std::move(p)));
+    p.reset(new int(3));
+    // Not moved from on failure.
+    EXPECT_FALSE(queue.TryPush(std::move(p)));
+    ASSERT_TRUE(p);
+    EXPECT_EQ(3, *p);
+    EXPECT_TRUE(queue.TryPop(&p));
+    EXPECT_EQ(1, *p);
+    // The remaining element is destroyed with the queue.
+}
+
+TEST(BoundedMpmcQueue, blocking)
+{
+    wsd::BoundedMpmcQueue<int> queue(2);
+    const int kNum = 10000;
+    std::thread consumer([&]() {
+        for (int i = 0; i < kNum; ++i) {
+            int v = -1;
+            queue.Pop(&v);
+            ASSERT_EQ(i, v);
+        }
+    });
+    for (int i = 0; i < kNum; ++i) {
+        queue.Push(i);
+    }
+    consumer.join();
+    int v = 0;
+    EXPECT_FALSE(queue.TryPop(&v));
+}
+
+TEST(BoundedMpmcQueue, multiple_producers_and_consumers)
+{
+    wsd::BoundedMpmcQueue<int> queue(16);
+    const int kThreads = 4;
+    const int kNum = 20000;
+    std::atomic<long> sum{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 1; i <= kNum; ++i) {
+                queue.Push(i);
+            }
+        });
+        threads.emplace_back([&]() {
+            long local = 0;
+            for (int i = 0; i < kNum; ++i) {
+                int v = 0;
+                if (i % 2 == 0) {
+                    queue.Pop(&v);
+                } else {
+                    while (!queue.TryPop(&v)) {
+                        std::this_thread::yield();
+                    }
+                }
+                local += v;
+            }
+            sum += local;
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(static_cast<long>(kThreads) * kNum * (kNum + 1) / 2, sum.load());
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "ms_queue.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(MsQueue, fifo)
+{
+    wsd::MsQueue<int> queue;
+    int v = 0;
+    EXPECT_FALSE(queue.TryPop(&v));
+    for (int i = 0; i < 100; ++i) {
+        queue.Push(i);
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(queue.TryPop(&v));
+        EXPECT_EQ(i, v);
+    }
+    EXPECT_FALSE(queue.TryPop(&v));
+}
+
+TEST(MsQueue, move_only)
+{
+    wsd::MsQueue<std::unique_ptr<int>> queue;
+    queue.Push(std::unique_ptr<int>(new int(1)));
+    queue.Push(std::unique_ptr<int>(new int(2)));
+    std::unique_ptr<int> p;
+    EXPECT_TRUE(queue.TryPop(&p));
+    EXPECT_EQ(1, *p);
+    // The remaining element is destroyed with the queue.
+}
+
+TEST(MsQueue, blocking)
+{
+    wsd::MsQueue<int> queue;
+    const int kNum = 10000;
+    std::thread consumer([&]() {
+        for (int i = 0; i < kNum; ++i) {
+            int v = -1;
+            queue.Pop(&v);
+            ASSERT_EQ(i, v);
+        }
+    });
+    for (int i = 0; i < kNum; ++i) {
+        queue.Push(i);
+        if (i % 100 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    int v = 0;
+    EXPECT_FALSE(queue.TryPop(&v));
+}
+
+TEST(MsQueue, multiple_producers_and_consumers)
+{
+    wsd::MsQueue<int> queue;
+    const int kThreads = 4;
+    const int kNum = 20000;
+    std::atomic<long> sum{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 1; i <= kNum; ++i) {
+                queue.Push(i);
+            }
+        });
+        threads.emplace_back([&]() {
+            long local = 0;
+            for (int i = 0; i < kNum; ++i) {
+                int v = 0;
+                if (i % 2 == 0) {
+                    queue.Pop(&v);
+                } else {
+                    while (!queue.TryPop(&v)) {
+                        std::this_thread::yield();
+                    }
+                }
+                local += v;
+            }
+            sum += local;
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(static_cast<long>(kThreads) * kNum * (kNum + 1) / 2, sum.load());
+}
+
+TEST(MsQueue, queues_created_and_destroyed_while_threads_live)
+{
+    // Every queue owns a hazard manager, and a new queue is likely allocated where the last
+    // one was, while the threads still have records of the destroyed ones.
+    const int kThreads = 4;
+    const int kRounds = 200;
+    std::atomic<wsd::MsQueue<int>*> queue{nullptr};
+    std::atomic<int> round{0};
+    std::atomic<int> num_done{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (int r = 1; r <= kRounds; ++r) {
+                while (round.load() != r) {
+                    std::this_thread::yield();
+                }
+                auto* q = queue.load();
+                for (int i = 0; i < 100; ++i) {
+                    q->Push(i);
+                    int v = 0;
+                    EXPECT_TRUE(q->TryPop(&v));
+                }
+                ++num_done;
+            }
+        });
+    }
+    for (int r = 1; r <= kRounds; ++r) {
+        std::unique_ptr<wsd::MsQueue<int>> q(new wsd::MsQueue<int>());
+        queue.store(q.get());
+        round.store(r);
+        while (num_done.load() != kThreads * r) {
+            std::this_thread::yield();
+        }
+        int v = 0;
+        EXPECT_FALSE(q->TryPop(&v));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
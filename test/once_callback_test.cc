@@ -0,0 +1,163 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "once_callback.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bind.h"
+#include "gtest/gtest.h"
+#include "wsd/es_test.h"
+
+namespace {
+
+// Counts copies, to check that bound arguments are moved.
+struct CopyCounted {
+    explicit CopyCounted(int* copies) : m_copies(copies)
+    {
+    }
+    CopyCounted(const CopyCounted& o) : m_copies(o.m_copies)
+    {
+        ++*m_copies;
+    }
+    CopyCounted(CopyCounted&& o) noexcept : m_copies(o.m_copies)
+    {
+    }
+    int* m_copies;
+};
+
+int takeUnique(std::unique_ptr<int> p, int n)
+{
+    return *p + n;
+}
+
+size_t takeBuffer(std::vector<char> buffer)
+{
+    return buffer.size();
+}
+
+std::string takeString(std::string s, const std::string& suffix)
+{
+    return s + suffix;
+}
+
+int takeCopyCounted(CopyCounted c)
+{
+    return *c.m_copies;
+}
+
+int addRef(const int& a, int&& b)
+{
+    return a + b;
+}
+
+class X {
+public:
+    explicit X(int x) : m_x(x)
+    {
+    }
+
+    int getX() const
+    {
+        return m_x;
+    }
+
+    int add(std::unique_ptr<int> p)
+    {
+        return m_x + *p;
+    }
+
+private:
+    int m_x;
+};
+
+}  // namespace
+
+TEST(once_callback, move_only_bound_args)
+{
+    wsd::OnceCallback<int(int)> cb1 = wsd::bindOnce(&takeUnique, std::unique_ptr<int>(new int(3)));
+    EXPECT_TRUE(cb1);
+    EXPECT_EQ(5, std::move(cb1)(2));
+    EXPECT_FALSE(cb1);
+
+    std::vector<char> buffer(1024);
+    wsd::OnceCallback<size_t()> cb2 = wsd::bindOnce(&takeBuffer, std::move(buffer));
+    EXPECT_EQ(1024U, std::move(cb2)());
+
+    // Unbound arguments are forwarded.
+    wsd::OnceCallback<int(std::unique_ptr<int>, int)> cb3 = wsd::bindOnce(&takeUnique);
+    EXPECT_EQ(4, std::move(cb3)(std::unique_ptr<int>(new int(1)), 3));
+    wsd::OnceCallback<int(int&&)> cb4 = wsd::bindOnce(&addRef, 1);
+    EXPECT_EQ(3, std::move(cb4)(2));
+}
+
+TEST(once_callback, bound_args_are_not_copied)
+{
+    int copies = 0;
+    wsd::OnceCallback<int()> cb1 = wsd::bindOnce(&takeCopyCounted, CopyCounted(&copies));
+    wsd::OnceCallback<int()> cb2(std::move(cb1));
+    wsd::OnceCallback<int()> cb3;
+    cb3 = std::move(cb2);
+    EXPECT_FALSE(cb1);
+    EXPECT_FALSE(cb2);
+    EXPECT_EQ(0, std::move(cb3)());
+    EXPECT_EQ(0, copies);
+
+    // Lvalues are copied once, into the callback.
+    CopyCounted c(&copies);
+    EXPECT_EQ(1, wsd::bindOnce(&takeCopyCounted, c)());
+
+    std::string s(1000, 'x');
+    wsd::OnceCallback<std::string(const std::string&)> cb4 = wsd::bindOnce(&takeString, std::move(s));
+    EXPECT_EQ(std::string(1000, 'x') + "y", std::move(cb4)("y"));
+}
+
+TEST(once_callback, methods)
+{
+    X x(3);
+    EXPECT_EQ(3, wsd::bindOnce(&X::getX, wsd::unretained(&x))());
+    EXPECT_EQ(4, wsd::bindOnce(&X::add, wsd::owned(new X(3)), std::unique_ptr<int>(new int(1)))());
+
+    std::shared_ptr<X> p(new X(5));
+    wsd::OnceCallback<int()> cb = wsd::bindOnce(&X::getX, wsd::shared(p));
+    EXPECT_EQ(2, p.use_count());
+    EXPECT_EQ(5, std::move(cb)());
+    // The bound state is destroyed once run.
+    EXPECT_EQ(1, p.use_count());
+}
+
+TEST(once_callback, from_callback)
+{
+    wsd::Callback<std::string(std::string, const std::string&)> callback = wsd::bind(&takeString);
+    wsd::OnceCallback<std::string(const std::string&)> cb = wsd::bindOnce(callback, std::string("x"));
+    EXPECT_EQ("xy", std::move(cb)("y"));
+
+    wsd::OnceCallback<std::string(std::string, const std::string&)> cb2 = callback;
+    EXPECT_EQ("ab", std::move(cb2)("a", "b"));
+    EXPECT_FALSE(wsd::OnceCallback<int()>(wsd::Callback<int()>()));
+}
+
+TEST(once_callback, small_state_is_inline)
+{
+    std::shared_ptr<X> p(new X(5));
+    std::unique_ptr<int> u(new int(1));
+
+    // The next memory allocation throws.
+    g_throw_counter = 0;
+    try {
+        wsd::OnceCallback<int(int)> cb1 = wsd::bindOnce(&takeUnique, std::move(u));
+        wsd::OnceCallback<int()> cb2 = wsd::bindOnce(&X::getX, wsd::shared(p));
+        wsd::OnceCallback<int(int)> cb3(std::move(cb1));
+        int n = std::move(cb3)(1) + std::move(cb2)();
+        g_throw_counter = -1;
+        EXPECT_EQ(7, n);
+    } catch (...) {
+        g_throw_counter = -1;
+        FAIL() << "small bound states should not allocate memory";
+    }
+}
@@ -6,7 +6,9 @@
 
 #include "promise.h"
 
+#include <chrono>
 #include <iostream>
+#include <thread>
 
 #include "bind.h"
 #include "es_test.h"
@@ -440,6 +442,136 @@ TEST(promise, iterator)
     }
 }
 
+void fail_with_interrupt(wsd::Promise<int> promise, const std::exception_ptr& e)
+{
+    promise.setException(e);
+}
+
+TEST(promise, cancel)
+{
+    wsd::Promise<int> p;
+    wsd::Future<int> f = p.getFuture();
+    EXPECT_FALSE(p.isInterrupted());
+    p.setInterruptHandler(wsd::bind(&fail_with_interrupt, p));
+    f.cancel();
+    EXPECT_TRUE(p.isInterrupted());
+    EXPECT_THROW(f.get(), wsd::FutureCancelledException);
+
+    // Interrupts to a done future are ignored.
+    wsd::Promise<int> p2;
+    p2.setValue(1);
+    p2.getFuture().cancel();
+    EXPECT_FALSE(p2.isInterrupted());
+    EXPECT_EQ(1, p2.getFuture().get());
+}
+
+TEST(promise, interrupt_handler_after_interrupt)
+{
+    wsd::Promise<int> p;
+    wsd::Future<int> f = p.getFuture();
+    f.raise(std::make_exception_ptr(std::runtime_error("")));
+    EXPECT_TRUE(p.isInterrupted());
+    EXPECT_FALSE(f.isDone());
+    p.setInterruptHandler(wsd::bind(&fail_with_interrupt, p));
+    EXPECT_THROW(f.get(), std::runtime_error);
+}
+
+int add_one(const wsd::Future<int>& f)
+{
+    return f.get() + 1;
+}
+
+wsd::Future<int> chain(wsd::Future<int> inner, const wsd::Future<int>&)
+{
+    return inner;
+}
+
+TEST(promise, cancel_propagates_through_then)
+{
+    wsd::Promise<int> p;
+    p.setInterruptHandler(wsd::bind(&fail_with_interrupt, p));
+    wsd::Future<int> f = p.getFuture().then(wsd::bind(&add_one)).then(wsd::bind(&add_one));
+    f.cancel();
+    EXPECT_TRUE(p.isInterrupted());
+    EXPECT_THROW(f.get(), wsd::FutureCancelledException);
+
+    // Interrupts reach the future returned by the callback once it runs.
+    wsd::Promise<int> p1;
+    wsd::Promise<int> p2;
+    p2.setInterruptHandler(wsd::bind(&fail_with_interrupt, p2));
+    wsd::Future<int> f2 = p1.getFuture().then(wsd::bind(&chain, p2.getFuture()));
+    p1.setValue(1);
+    EXPECT_FALSE(f2.isDone());
+    f2.cancel();
+    EXPECT_TRUE(p2.isInterrupted());
+    EXPECT_THROW(f2.get(), wsd::FutureCancelledException);
+}
+
+TEST(promise, within)
+{
+    wsd::Promise<int> p;
+    wsd::Future<int> f = p.getFuture().within(10);
+    EXPECT_THROW(f.get(), wsd::FutureTimeoutException);
+    EXPECT_TRUE(p.isInterrupted());
+    p.setValue(1);
+
+    wsd::Promise<int> p2;
+    wsd::Future<int> f2 = p2.getFuture().within(60 * 1000);
+    p2.setValue(2);
+    EXPECT_EQ(2, f2.get());
+    EXPECT_FALSE(p2.isInterrupted());
+
+    EXPECT_THROW(wsd::Future<int>().within(10), wsd::FutureUninitialized);
+}
+
+TEST(promise, combinators_forward_interrupts)
+{
+    std::vector<wsd::Promise<int>> promises(3);
+    std::vector<wsd::Future<int>> futures;
+    for (size_t i = 0; i < promises.size(); i++) futures.push_back(promises[i].getFuture());
+
+    // whenAny() cancels the losers.
+    wsd::Future<std::pair<size_t, wsd::Future<int>>> any = wsd::whenAny<int>(futures.begin(), futures.end());
+    promises[1].setValue(1);
+    EXPECT_EQ(1u, any.get().first);
+    EXPECT_TRUE(promises[0].isInterrupted());
+    EXPECT_FALSE(promises[1].isInterrupted());
+    EXPECT_TRUE(promises[2].isInterrupted());
+
+    // Cancelling the result of whenAll() cancels all the futures.
+    wsd::Promise<int> p1;
+    wsd::Promise<void> p2;
+    wsd::whenAll(p1.getFuture(), p2.getFuture()).cancel();
+    EXPECT_TRUE(p1.isInterrupted());
+    EXPECT_TRUE(p2.isInterrupted());
+}
+
+TEST(promise, wait_for)
+{
+    wsd::Promise<int> p;
+    wsd::Future<int> f = p.getFuture();
+    EXPECT_FALSE(f.waitFor(std::chrono::milliseconds(10)));
+    EXPECT_FALSE(f.waitUntil(std::chrono::system_clock::now() + std::chrono::milliseconds(10)));
+    int i = 0;
+    EXPECT_FALSE(f.tryGet(i));
+    EXPECT_FALSE(f.tryGet(i, std::chrono::milliseconds(10)));
+
+    std::thread t([&p] { p.setValue(1); });
+    EXPECT_TRUE(f.tryGet(i, std::chrono::seconds(60)));
+    EXPECT_EQ(1, i);
+    EXPECT_TRUE(f.waitFor(std::chrono::milliseconds(0)));
+    t.join();
+
+    wsd::Promise<void> p2;
+    p2.setException(std::make_exception_ptr(std::runtime_error("")));
+    EXPECT_TRUE(p2.getFuture().waitUntil(std::chrono::steady_clock::now()));
+
+    wsd::Future<int> f3(std::make_exception_ptr(std::runtime_error("")));
+    EXPECT_TRUE(f3.waitFor(std::chrono::milliseconds(0)));
+    EXPECT_THROW(f3.tryGet(i), std::runtime_error);
+    EXPECT_THROW(wsd::Future<int>().waitFor(std::chrono::milliseconds(0)), wsd::FutureUninitialized);
+}
+
 void run_or_not_run(const wsd::Future<TestClass>& f)
 {
     EXPECT_TRUE(f.isDone());
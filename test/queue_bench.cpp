@@ -0,0 +1,85 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+
+#include "wsd/benchmark.h"
+#include "wsd/mpmc_queue.h"
+#include "wsd/ms_queue.h"
+
+namespace {
+
+// The baseline: a std::queue guarded by a mutex.
+template <typename T>
+class MutexQueue {
+public:
+    void Push(T value)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push(value);
+        }
+        m_cond.notify_one();
+    }
+
+    void Pop(T* value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait(lock, [this]() { return !m_queue.empty(); });
+        *value = m_queue.front();
+        m_queue.pop();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::queue<T> m_queue;
+};
+
+}  // namespace
+
+// Each operation pushes an element and pops one, so the queues stay short and every
+// thread is both a producer and a consumer.
+class QueueBench : public wsd::benchmark::Test {
+protected:
+    wsd::BoundedMpmcQueue<int> m_bounded{1024};
+    wsd::MsQueue<int> m_ms;
+    MutexQueue<int> m_mutex;
+};
+
+TEST_CASE(QueueBench, bounded)
+{
+    int v = 0;
+    m_bounded.Push(1);
+    m_bounded.Pop(&v);
+    return v;
+}
+
+TEST_CASE(QueueBench, bounded_try)
+{
+    int v = 0;
+    m_bounded.TryPush(1);
+    m_bounded.TryPop(&v);
+    return v;
+}
+
+TEST_CASE(QueueBench, ms)
+{
+    int v = 0;
+    m_ms.Push(1);
+    m_ms.Pop(&v);
+    return v;
+}
+
+TEST_CASE(QueueBench, mutex)
+{
+    int v = 0;
+    m_mutex.Push(1);
+    m_mutex.Pop(&v);
+    return v;
+}
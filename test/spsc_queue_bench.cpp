@@ -0,0 +1,116 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+// Run with --concurrency=1, since the thread running the test is the only producer.
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "wsd/benchmark.h"
+#include "wsd/spsc_queue.h"
+
+namespace {
+
+constexpr int kBatchSize = 64;
+
+// The baseline: a std::queue guarded by a mutex.
+class MutexQueue {
+public:
+    // Unbounded, unlike the queue compared with.
+    explicit MutexQueue(size_t)
+    {
+    }
+
+    void PushN(int* values, int n)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (int i = 0; i < n; ++i) {
+                m_queue.push(values[i]);
+            }
+        }
+        m_cond.notify_one();
+    }
+
+    int PopN(int* values, int n)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait(lock, [this]() { return !m_queue.empty(); });
+        int popped = 0;
+        for (; popped < n && !m_queue.empty(); ++popped) {
+            values[popped] = m_queue.front();
+            m_queue.pop();
+        }
+        return popped;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::queue<int> m_queue;
+};
+
+}  // namespace
+
+// Each operation hands items to a consumer thread, as a pipeline stage does. The
+// consumer drains the queue in batches until it pops -1.
+template <typename Queue>
+class PipelineBench : public wsd::benchmark::Test {
+public:
+    void SetUp() override
+    {
+        m_consumer = std::thread([this]() {
+            int values[kBatchSize];
+            while (true) {
+                int n = static_cast<int>(m_queue.PopN(values, kBatchSize));
+                if (values[n - 1] == -1) {
+                    break;
+                }
+            }
+        });
+    }
+
+    void TearDown() override
+    {
+        int end = -1;
+        m_queue.PushN(&end, 1);
+        m_consumer.join();
+    }
+
+protected:
+    Queue m_queue{4096};
+    std::thread m_consumer;
+    int m_values[kBatchSize] = {0};
+};
+
+class SpscQueueBench : public PipelineBench<wsd::SpscQueue<int>> {};
+
+class MutexQueueBench : public PipelineBench<MutexQueue> {};
+
+TEST_CASE(SpscQueueBench, push)
+{
+    m_queue.PushN(m_values, 1);
+    return 0;
+}
+
+TEST_CASE(SpscQueueBench, push_batch)
+{
+    m_queue.PushN(m_values, kBatchSize);
+    return 0;
+}
+
+TEST_CASE(MutexQueueBench, push)
+{
+    m_queue.PushN(m_values, 1);
+    return 0;
+}
+
+TEST_CASE(MutexQueueBench, push_batch)
+{
+    m_queue.PushN(m_values, kBatchSize);
+    return 0;
+}
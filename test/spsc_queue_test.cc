@@ -0,0 +1,99 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "spsc_queue.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(SpscQueue, capacity)
+{
+    EXPECT_EQ(2u, wsd::SpscQueue<int>(1).capacity());
+    EXPECT_EQ(8u, wsd::SpscQueue<int>(5).capacity());
+}
+
+TEST(SpscQueue, fifo)
+{
+    wsd::SpscQueue<int> queue(4);
+    int v = 0;
+    EXPECT_FALSE(queue.TryPop(&v));
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(queue.TryPush(i));
+        }
+        EXPECT_FALSE(queue.TryPush(4));
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(queue.TryPop(&v));
+            EXPECT_EQ(i, v);
+        }
+        EXPECT_FALSE(queue.TryPop(&v));
+    }
+}
+
+TEST(SpscQueue, batch)
+{
+    wsd::SpscQueue<int> queue(8);
+    int in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int out[10] = {0};
+    EXPECT_EQ(0u, queue.TryPushN(in, 0));
+    EXPECT_EQ(5u, queue.TryPushN(in, 5));
+    // Only 3 more fit.
+    EXPECT_EQ(3u, queue.TryPushN(in + 5, 5));
+    EXPECT_EQ(0u, queue.TryPushN(in + 8, 2));
+    EXPECT_EQ(6u, queue.TryPopN(out, 6));
+    EXPECT_EQ(2u, queue.TryPushN(in + 8, 2));
+    EXPECT_EQ(4u, queue.TryPopN(out + 6, 10));
+    EXPECT_EQ(0u, queue.TryPopN(out, 10));
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(i, out[i]);
+    }
+}
+
+TEST(SpscQueue, move_only)
+{
+    wsd::SpscQueue<std::unique_ptr<int>> queue(2);
+    std::unique_ptr<int> p(new int(1));
+    EXPECT_TRUE(queue.TryPush(std::move(p)));
+    EXPECT_FALSE(p);
+    queue.Push(std::unique_ptr<int>(new int(2)));
+    p.reset(new int(3));
+    // Not moved from on failure.
+    EXPECT_FALSE(queue.TryPush(std::move(p)));
+    ASSERT_TRUE(p);
+    EXPECT_TRUE(queue.TryPop(&p));
+    EXPECT_EQ(1, *p);
+    // The remaining element is destroyed with the queue.
+}
+
+TEST(SpscQueue, blocking)
+{
+    wsd::SpscQueue<int> queue(16);
+    const int kNum = 100000;
+    std::thread consumer([&]() {
+        std::vector<int> buffer(7);
+        int expected = 0;
+        while (expected <= kNum) {
+            size_t n = queue.PopN(buffer.data(), buffer.size());
+            ASSERT_GT(n, 0u);
+            for (size_t i = 0; i < n; ++i, ++expected) {
+                // Ends with -1.
+                ASSERT_EQ(expected < kNum ? expected : -1, buffer[i]);
+            }
+        }
+    });
+    std::vector<int> values(kNum);
+    for (int i = 0; i < kNum; ++i) {
+        values[i] = i;
+    }
+    for (int i = 0; i < kNum; i += 10) {
+        queue.PushN(&values[i], 10);
+    }
+    queue.Push(-1);
+    consumer.join();
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include <mutex>
+#include <vector>
+
+#include "wsd/benchmark.h"
+#include "wsd/lock_free_stack.h"
+
+namespace {
+
+// The baseline: a std::vector guarded by a mutex.
+class MutexStack {
+public:
+    void Push(int value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_values.push_back(value);
+    }
+
+    bool TryPop(int* value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_values.empty()) {
+            return false;
+        }
+        *value = m_values.back();
+        m_values.pop_back();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<int> m_values;
+};
+
+}  // namespace
+
+// Each operation takes an object from a free list and puts it back, as object pools
+// do. Run with a high --concurrency to see the elimination pay off.
+class StackBench : public wsd::benchmark::Test {
+public:
+    StackBench()
+    {
+        for (int i = 0; i < 1024; ++i) {
+            m_treiber.Push(i);
+            m_elimination.Push(i);
+            m_mutex.Push(i);
+        }
+    }
+
+protected:
+    wsd::LockFreeStack<int> m_treiber;
+    wsd::EliminationBackoffStack<int> m_elimination{8};
+    MutexStack m_mutex;
+};
+
+TEST_CASE(StackBench, treiber)
+{
+    int v = 0;
+    if (m_treiber.TryPop(&v)) {
+        m_treiber.Push(v);
+    }
+    return 0;
+}
+
+TEST_CASE(StackBench, elimination)
+{
+    int v = 0;
+    if (m_elimination.TryPop(&v)) {
+        m_elimination.Push(v);
+    }
+    return 0;
+}
+
+TEST_CASE(StackBench, mutex)
+{
+    int v = 0;
+    if (m_mutex.TryPop(&v)) {
+        m_mutex.Push(v);
+    }
+    return 0;
+}
@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -189,3 +190,171 @@ TEST(when_all, exception_safety)
     }
     g_throw_counter = -1;
 }
+
+TEST(when_any, first_done)
+{
+    vector<wsd::Promise<int>> ps(3);
+    vector<wsd::Future<int>> fs;
+    for (size_t i = 0; i < ps.size(); i++) {
+        fs.push_back(ps[i].getFuture());
+    }
+
+    wsd::Future<pair<size_t, wsd::Future<int>>> any = wsd::whenAny<int>(fs.begin(), fs.end());
+    EXPECT_FALSE(any.isDone());
+    ps[1].setValue(1);
+    EXPECT_TRUE(any.hasValue());
+    EXPECT_EQ(1U, any.get().first);
+    EXPECT_EQ(1, any.get().second.get());
+
+    // The others are ignored.
+    ps[0].setValue(0);
+    ps[2].setException(std::make_exception_ptr(std::runtime_error("error")));
+    EXPECT_EQ(1U, any.get().first);
+}
+
+TEST(when_any, exception)
+{
+    vector<wsd::Promise<int>> ps(2);
+    vector<wsd::Future<int>> fs;
+    for (size_t i = 0; i < ps.size(); i++) {
+        fs.push_back(ps[i].getFuture());
+    }
+
+    wsd::Future<pair<size_t, wsd::Future<int>>> any = wsd::whenAny<int>(fs.begin(), fs.end());
+    ps[1].setException(std::make_exception_ptr(std::runtime_error("error")));
+    EXPECT_TRUE(any.hasValue());
+    EXPECT_EQ(1U, any.get().first);
+    EXPECT_THROW(any.get().second.get(), std::runtime_error);
+}
+
+TEST(when_n, quorum)
+{
+    vector<wsd::Promise<int>> ps(5);
+    vector<wsd::Future<int>> fs;
+    for (size_t i = 0; i < ps.size(); i++) {
+        fs.push_back(ps[i].getFuture());
+    }
+    ps[3].setValue(3);
+
+    wsd::Future<vector<pair<size_t, wsd::Future<int>>>> quorum = wsd::whenN<int>(fs.begin(), fs.end(), 3);
+    EXPECT_FALSE(quorum.isDone());
+    ps[0].setException(std::make_exception_ptr(std::runtime_error("error")));
+    EXPECT_FALSE(quorum.isDone());
+    ps[4].setValue(4);
+    EXPECT_TRUE(quorum.hasValue());
+    ps[1].setValue(1);
+
+    const vector<pair<size_t, wsd::Future<int>>>& done = quorum.get();
+    ASSERT_EQ(3U, done.size());
+    EXPECT_EQ(3U, done[0].first);
+    EXPECT_EQ(3, done[0].second.get());
+    EXPECT_EQ(0U, done[1].first);
+    EXPECT_TRUE(done[1].second.hasException());
+    EXPECT_EQ(4U, done[2].first);
+    EXPECT_EQ(4, done[2].second.get());
+}
+
+TEST(collect_all, values)
+{
+    vector<wsd::Promise<TestClass>> ps(3);
+    vector<wsd::Future<TestClass>> fs;
+    for (size_t i = 0; i < ps.size(); i++) {
+        fs.push_back(ps[i].getFuture());
+    }
+
+    wsd::Future<vector<TestClass>> all = wsd::collectAll<TestClass>(fs.begin(), fs.end());
+    ps[2].setValue(TestClass(0xCC));
+    ps[0].setValue(TestClass(0xAA));
+    EXPECT_FALSE(all.isDone());
+    ps[1].setValue(TestClass(0xBB));
+    EXPECT_TRUE(all.hasValue());
+    ASSERT_EQ(3U, all.get().size());
+    EXPECT_EQ(0xAA, *all.get()[0].p);
+    EXPECT_EQ(0xBB, *all.get()[1].p);
+    EXPECT_EQ(0xCC, *all.get()[2].p);
+}
+
+TEST(collect_all, fail_fast)
+{
+    vector<wsd::Promise<int>> ps(3);
+    vector<wsd::Future<int>> fs;
+    for (size_t i = 0; i < ps.size(); i++) {
+        fs.push_back(ps[i].getFuture());
+    }
+
+    wsd::Future<vector<int>> all = wsd::collectAll<int>(fs.begin(), fs.end());
+    ps[0].setValue(0);
+    ps[1].setException(std::make_exception_ptr(std::runtime_error("error")));
+    // Do not wait for the last one.
+    EXPECT_TRUE(all.hasException());
+    EXPECT_THROW(all.get(), std::runtime_error);
+    ps[2].setValue(2);
+    EXPECT_THROW(all.get(), std::runtime_error);
+}
+
+TEST(when_all, variadic)
+{
+    wsd::Promise<int> p1;
+    wsd::Promise<void> p2;
+    wsd::Promise<TestClass> p3;
+    wsd::Promise<int> p4;
+    wsd::Future<std::tuple<wsd::Future<int>, wsd::Future<void>, wsd::Future<TestClass>, wsd::Future<int>>> all =
+            wsd::whenAll(p1.getFuture(), p2.getFuture(), p3.getFuture(), p4.getFuture());
+    p4.setException(std::make_exception_ptr(std::runtime_error("error")));
+    p2.set();
+    p1.setValue(1);
+    EXPECT_FALSE(all.isDone());
+    p3.setValue(TestClass(0xCC));
+    EXPECT_TRUE(all.hasValue());
+    EXPECT_EQ(1, std::get<0>(all.get()).get());
+    EXPECT_TRUE(std::get<1>(all.get()).hasValue());
+    EXPECT_EQ(0xCC, *std::get<2>(all.get()).get().p);
+    EXPECT_THROW(std::get<3>(all.get()).get(), std::runtime_error);
+}
+
+TEST(when_all, many_threads)
+{
+    const int kFutures = 1000;
+    vector<wsd::Promise<int>> ps(kFutures);
+    vector<wsd::Future<int>> fs;
+    for (int i = 0; i < kFutures; i++) {
+        fs.push_back(ps[i].getFuture());
+    }
+    wsd::Future<vector<wsd::Future<int>>> all = wsd::whenAll<int>(fs.begin(), fs.end());
+
+    vector<thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&ps, t] {
+            for (int i = t; i < kFutures; i += 4) {
+                ps[i].setValue(i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_TRUE(all.hasValue());
+    for (int i = 0; i < kFutures; i++) {
+        EXPECT_EQ(i, all.get()[i].get());
+    }
+}
+
+TEST(wait_all, deadline)
+{
+    vector<wsd::Promise<int>> ps(3);
+    vector<wsd::Future<int>> fs;
+    for (size_t i = 0; i < ps.size(); i++) {
+        fs.push_back(ps[i].getFuture());
+    }
+    ps[0].setValue(0);
+    EXPECT_FALSE(wsd::waitAll<int>(fs.begin(), fs.end(), std::chrono::milliseconds(10)));
+
+    thread t([&ps] {
+        ps[1].setValue(1);
+        ps[2].setException(std::make_exception_ptr(std::runtime_error("")));
+    });
+    EXPECT_TRUE(wsd::waitAll<int>(fs.begin(), fs.end(), std::chrono::system_clock::now() + std::chrono::seconds(60)));
+    t.join();
+    EXPECT_TRUE(fs[1].hasValue());
+    EXPECT_TRUE(fs[2].hasException());
+}
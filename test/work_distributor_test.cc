@@ -0,0 +1,91 @@
+// Copyright (c) 2021 spockwang.
+//     All rights reserved.
+//
+// Author: wbbtiger@gmail.com
+//
+
+#include "work_distributor.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(WorkDistributor, balanced)
+{
+    const int kQueues = 8;
+    const int kThreads = 16;
+    const int kTasks = 1000;
+    wsd::WorkDistributor<int> distributor(kQueues);
+    EXPECT_EQ(kQueues, distributor.num_queues());
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&distributor, i]() {
+            for (int j = 0; j < kTasks; ++j) {
+                distributor.Submit(i * kTasks + j);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::vector<int> all;
+    for (int q = 0; q < kQueues; ++q) {
+        int n = 0;
+        int task;
+        while (distributor.TryTake(q, &task)) {
+            all.push_back(task);
+            ++n;
+        }
+        EXPECT_EQ(kThreads * kTasks / kQueues, n);
+    }
+    std::sort(all.begin(), all.end());
+    for (int i = 0; i < kThreads * kTasks; ++i) {
+        ASSERT_EQ(i, all[i]);
+    }
+}
+
+TEST(WorkDistributor, bad_queue)
+{
+    wsd::WorkDistributor<int> distributor(4);
+    int task;
+    EXPECT_THROW(distributor.TryTake(-1, &task), std::invalid_argument);
+    EXPECT_THROW(distributor.TryTake(4, &task), std::invalid_argument);
+    EXPECT_THROW(distributor.Take(4, &task), std::invalid_argument);
+}
+
+TEST(WorkDistributor, workers)
+{
+    const int kQueues = 4;
+    const int kTasks = 10000;
+    wsd::WorkDistributor<std::unique_ptr<int>> distributor(kQueues);
+    std::vector<long> sums(kQueues);
+    std::vector<std::thread> workers;
+    for (int q = 0; q < kQueues; ++q) {
+        workers.emplace_back([&, q]() {
+            std::unique_ptr<int> task;
+            // A negative task stops the worker taking it.
+            for (distributor.Take(q, &task); *task >= 0; distributor.Take(q, &task)) {
+                sums[q] += *task;
+            }
+        });
+    }
+    for (int i = 0; i < kTasks; ++i) {
+        distributor.Submit(std::unique_ptr<int>(new int(i)));
+    }
+    // One stop task per queue, since the queues are balanced again after kQueues.
+    for (int q = 0; q < kQueues; ++q) {
+        distributor.Submit(std::unique_ptr<int>(new int(-1)));
+    }
+    for (auto& t : workers) {
+        t.join();
+    }
+    long sum = 0;
+    for (long s : sums) {
+        sum += s;
+    }
+    EXPECT_EQ(static_cast<long>(kTasks) * (kTasks - 1) / 2, sum);
+}